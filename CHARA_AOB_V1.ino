@@ -12,11 +12,12 @@
 #include "dm_556_rs_constants.h"
 #include "runtime_state.h"
 #include "dm_556_rs_frames.h"
-#include "motor_ids.h"
 #include "driver_io.h"
 #include "parse.h"
 #include "monitors.h"
 #include "motor_init.h"
+#include "bus_baud.h"
+#include "boot.h"
 #include "fan.h"
 #include "nv_store.h"
 #include "laser.h"
@@ -31,8 +32,10 @@ bool g_adminMode = false;
 /* Global engineering mode flag */
 bool g_engineeringMode = false;
 
-/* ─── Ethernet server and RX line buffer ───────────────────────────── */
+/* ─── Ethernet server and RX line buffers (TCP, serial console) ────── */
 static unsigned char packetReceived[MAX_PACKET_LENGTH];
+static char          serialLine[MAX_PACKET_LENGTH];
+static uint16_t      serialLen = 0;
 static EthernetServer server(PORT_NUM);
 EthernetClient client;
 
@@ -41,7 +44,7 @@ uint8_t  fanSetpoint = 0;    // 0..255
 bool     fanWasOn    = false;
 
 /* ─── Motion-state polling enable flags (per motor) ────────────────── */
-bool pollEnabled[23] = { false, false, false };
+bool pollEnabled[MAX_AXES + 1] = { false };
 
 /* ─── Debug helper: read key DM556RS registers for one motor ─────────
    Reads:
@@ -72,26 +75,8 @@ static void debugMotor(uint8_t id) {
   Serial.println("=========================");
 }
 
-/* ─── setup() — hardware bring-up ──────────────────────────────────── */
-void setup() {
-  Serial.begin(9600);
-  uint32_t t0 = millis();
-  while (!Serial && millis() - t0 < 3000) {}
-
-  fanSetup();
-  laserSetup();               // IO1 initial HIGH; runtime toggled via "laser on/off"
-
-  // SD init + NV image prepare/load
-  nvInit();
-  nvLoadAllFromDisk();
-
-  // Read network settings from SD card
-  readNetworkConfig(client);
-
-  while (Ethernet.linkStatus() == LinkOFF) {
-    delay(500);
-  }
-
+/* ─── Network bring-up (called from boot.h once the link is up) ────── */
+void bootStartNetwork() {
   byte mac[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED };
 
   // Use network config from SD card (or defaults if read failed)
@@ -101,23 +86,37 @@ void setup() {
   IPAddress subnet  = g_deviceSubnet;
 
   Ethernet.begin(mac, ip, dns, gateway, subnet);
-  
+
   // Create server with configured port
   EthernetServer configuredServer(g_port);
   server = configuredServer;
   server.begin();
+}
 
-  // RS-485 buses: COM-1 always; COM-0 optional
-  SerialPort.begin(MODBUS_BAUD);
-#if USE_COM0
-  Serial0.begin(MODBUS_BAUD);
-#endif
+/* ─── setup() — local bring-up only (SD, NV, settings) ─────────────── */
+void setup() {
+  Serial.begin(9600);
+  uint32_t t0 = millis();
+  while (!Serial && millis() - t0 < SERIAL_WAIT_MS) {}
 
-  delay(500);
-  initAllDrivers();
+  fanSetup();
+  laserSetup();               // IO1 at LASER_BOOT_ON; runtime toggled via "laser on/off"
+  estopSetup();               // optional e-stop input (USE_ESTOP_PIN)
+  mbRxSetup();                // bus receive rings, drained by a timer interrupt
 
-  Serial.println("System ready. Commands: Mx,steps | Mx st t|f | Mx,s | stop all | Mx set lo|hi | Mx read | admin on|off | laser on|off | FG / FS");
-  client.println("System ready. Commands: Mx,steps | Mx st t|f | Mx,s | stop all | Mx set lo|hi | Mx read | admin on|off | laser on|off | FG / FS");
+  // SD init + NV image prepare/load (axis table from the last bus scan, if any)
+  motorStatesInit();
+  coalesceInit();
+  nvInit();
+  nvLoadAllFromDisk();
+  nvLoadAxisTable();
+  historyInit();
+
+  // Read network settings from SD card
+  readNetworkConfig(client);
+
+  // Ethernet link and driver configuration come up in parallel from loop() (boot.h)
+  Serial.println("Local init done; waiting for link and drivers");
 
   // Debug one motor at startup (change ID as needed)
 
@@ -126,16 +125,30 @@ void setup() {
 /* ─── loop() — cooperative scheduler ───────────────────────────────── */
 void loop() {
   
+  serviceEstop();               // before anything else may touch the bus
+  serviceBoot();
   fanRefresh();
-  monitorLimitSwitches_M12();   // ONLY M1 and M2
-  monitorMotionStates();
+  if (bootDriversReady()) {     // no bus polling while drivers are still being configured
+    monitorLimitSwitches_M12();   // ONLY M1 and M2
+    monitorMotionStates();
+    monitorMoveCompletion();
+    serviceHoming();
+    serviceTracking();
+    serviceAlarmScan();
+    serviceCoalesce();
+    serviceScript();
+    serviceDriverSync();          // drivers that did not answer at boot / scan
+  }
 
-  EthernetClient nc = server.accept();
-  if (nc.connected()) {
-    if (client.connected()) {
-      client.stop();
+  if (bootNetUp()) {
+    EthernetClient nc = server.accept();
+    if (nc.connected()) {
+      if (client.connected()) {
+        client.stop();
+      }
+      client = nc;
+      telemetryStop();            // subscriptions belong to the previous client
     }
-    client = nc;
   }
 
   if (client.connected()) {
@@ -149,19 +162,32 @@ void loop() {
     }
     if (len) {
       packetReceived[len] = '\0';
+      bootNoteCommand();
       parseLine(reinterpret_cast<char *>(packetReceived));
       memset(packetReceived, 0, len);
     }
   }
 
-  uint32_t now = millis();
-  for (uint8_t id = 1; id <= 22; ++id) {
-    MotorState &m = mById(id);
-    if (m.enabled && now - m.lastMoveMs >= DISABLE_TIMEOUT_MS) {
-      disableMotorHW(id);
+  // Serial console: same commands as TCP (e.g. "estop" from a laptop on USB)
+  while (Serial.available() > 0) {
+    char c = static_cast<char>(Serial.read());
+    if (c == '\n' || c == '\r') {
+      if (serialLen) {
+        serialLine[serialLen] = '\0';
+        bootNoteCommand();
+        parseLine(serialLine);
+        serialLen = 0;
+      }
+      break;                      // one line per pass, like TCP
     }
+    if (serialLen < MAX_PACKET_LENGTH - 1) serialLine[serialLen++] = c;
   }
-  
+
+  serviceAutoDisable();
+  serviceTelemetry();
+  serviceHistory();
+  serviceLaser();
+
   EthernetMgr.Refresh();
 
 }
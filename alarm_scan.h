@@ -0,0 +1,77 @@
+#ifndef ALARM_SCAN_H
+#define ALARM_SCAN_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "output.h"
+#include "dm_556_rs_constants.h"
+#include "axis_table.h"
+#include "driver_io.h"
+#include "runtime_state.h"
+#include "trace.h"
+
+/* ── Background alarm scan ───────────────────────────────────────────
+   One REG_ALARM_STATUS read every ALARM_SCAN_MS, round-robin over the
+   axis table (22 axes: every axis about every 5.5 s), so an alarm is
+   noticed without anyone asking and "read errors" is answered from the
+   cache instantly. Each axis keeps its last alarm word (MotorState.alarm)
+   and when it was read; a driver that stops answering is flagged
+   "no reply" but keeps its last word.
+
+   Every transition is pushed as an event line:
+     m3, alarm=0x80            (new / changed alarm)
+     m3, alarm cleared
+     m3, alarm no reply
+   A new alarm also marks the driver state lost (see driverStateLost).
+   Homing and "read errors fresh" feed the same cache via alarmNote().
+*/
+struct AlarmCache {
+  uint32_t atMs;       // millis() of the last read attempt (0 = never)
+  bool     noReply;    // last read timed out
+};
+
+static AlarmCache g_alarm[MAX_AXES + 1];
+
+// Record a REG_ALARM_STATUS read (0xFFFF = no reply) and push transitions
+static inline void alarmNote(uint8_t id, uint16_t code) {
+  MotorState &m = mById(id);
+  AlarmCache &c = g_alarm[id];
+  c.atMs = millis() | 1u;
+
+  if (code == 0xFFFF) {
+    if (!c.noReply) printLineBoth("m" + String(id) + ", alarm no reply");
+    c.noReply = true;
+    return;
+  }
+  c.noReply = false;
+  if (code == m.alarm) return;
+
+  const uint16_t was = m.alarm;
+  m.alarm = code;
+  traceAlarm(id, code);
+  if (code != 0) {
+    driverStateLost(id);                    // alarm: driver state no longer trusted
+    printLineBoth("m" + String(id) + ", alarm=0x" + String(code, HEX));
+  } else if (was != 0) {
+    printLineBoth("m" + String(id) + ", alarm cleared");
+  }
+}
+
+static inline uint16_t alarmReadNow(uint8_t id) {
+  const uint16_t code = readReg(id, REG_ALARM_STATUS);
+  alarmNote(id, code);
+  return code;
+}
+
+static inline void serviceAlarmScan() {
+  static uint32_t lastMs = 0;
+  static uint8_t  next   = 0;     // index into g_axes.ids
+  if (!g_axes.count) return;
+  if (millis() - lastMs < ALARM_SCAN_MS) return;
+  lastMs = millis();
+
+  if (next >= g_axes.count) next = 0;
+  alarmReadNow(g_axes.ids[next++]);
+}
+
+#endif // ALARM_SCAN_H
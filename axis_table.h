@@ -0,0 +1,50 @@
+#ifndef AXIS_TABLE_H
+#define AXIS_TABLE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/* ── Axis table (which slave ids exist, and on which bus) ────────────
+   Slave ids run 1..MAX_AXES; per-axis arrays are sized MAX_AXES + 1 and
+   indexed by id. The table lists the ids that actually answered the
+   last bus scan ("bus scan", or at first boot) in ascending order, plus
+   the RS-485 port each one answered on, so frames go out only on that
+   port and loops visit only present axes. It is persisted in the NV
+   globals; bus I/O lives in driver_io.h / motor_init.h.
+*/
+static const uint8_t AXIS_PORT_NONE = 0;
+static const uint8_t AXIS_PORT_A    = 1;   // SerialPortA (COM-1)
+static const uint8_t AXIS_PORT_B    = 2;   // SerialPortB (COM-0)
+
+struct AxisTable {
+  uint8_t count;
+  uint8_t ids[MAX_AXES];           // present ids, ascending
+  uint8_t port[MAX_AXES + 1];      // per id: AXIS_PORT_*, NONE = absent
+};
+
+static AxisTable g_axes;
+
+static inline bool axisValidId(uint8_t id) {
+  return id >= 1 && id <= MAX_AXES;
+}
+
+static inline bool axisPresent(uint8_t id) {
+  return axisValidId(id) && g_axes.port[id] != AXIS_PORT_NONE;
+}
+
+// Port mask for frames to `id`: unknown ids (and broadcasts) go to both buses
+static inline uint8_t axisPortMask(uint8_t id) {
+  return axisPresent(id) ? g_axes.port[id] : (uint8_t)(AXIS_PORT_A | AXIS_PORT_B);
+}
+
+// Rebuild the table from a per-id port array (index 1..MAX_AXES)
+static inline void axisTableSet(const uint8_t *port) {
+  g_axes.count = 0;
+  g_axes.port[0] = AXIS_PORT_NONE;
+  for (uint8_t id = 1; id <= MAX_AXES; ++id) {
+    g_axes.port[id] = port[id];
+    if (port[id] != AXIS_PORT_NONE) g_axes.ids[g_axes.count++] = id;
+  }
+}
+
+#endif // AXIS_TABLE_H
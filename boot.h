@@ -0,0 +1,129 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <Arduino.h>
+#include <Ethernet.h>
+#include "config.h"
+#include "axis_table.h"
+#include "driver_io.h"
+#include "motor_init.h"
+#include "bus_baud.h"
+
+/* ── Staged startup ──────────────────────────────────────────────────
+   setup() only does the local work (SD, NV image, network.txt) and
+   returns; two independent stages then advance from loop():
+
+     network: wait for the Ethernet link (non-blocking) -> start the
+              TCP server as soon as it is up
+     drivers: wait until DRIVER_POWERUP_MS after reset -> find the bus
+              rate -> read-compare / configure one axis per loop pass
+              (an axis that does not answer yet is retried later by
+              serviceDriverSync(), motor_init.h)
+
+   A missing cable or a slow switch therefore no longer keeps the
+   drivers unconfigured, and the server comes up while drivers are still
+   being configured. Commands for an axis are accepted once that axis
+   has been configured; bus-wide commands wait for the drivers stage.
+   Stage times and the time to the first command are reported on Serial
+   and by the "boot" command.
+*/
+enum BootNetStage : uint8_t { BOOT_NET_LINK = 0, BOOT_NET_UP };
+enum BootDrvStage : uint8_t { BOOT_DRV_POWERUP = 0, BOOT_DRV_INIT, BOOT_DRV_DONE };
+
+struct BootState {
+  BootNetStage net;
+  BootDrvStage drv;
+  uint8_t  next;              // index into g_axes.ids during BOOT_DRV_INIT
+  uint8_t  missing, updated;
+  uint16_t frames;
+  uint32_t drvStartMs;
+  uint32_t netUpMs, drvDoneMs, firstCmdMs;   // 0 = not yet
+  bool     axisReady[MAX_AXES + 1];
+};
+
+static BootState g_boot;
+
+// Provided by main: Ethernet.begin() + server.begin() with the loaded settings
+void bootStartNetwork();
+
+static inline bool bootNetUp()        { return g_boot.net == BOOT_NET_UP; }
+static inline bool bootDriversReady() { return g_boot.drv == BOOT_DRV_DONE; }
+static inline bool bootAxisReady(uint8_t id) {
+  return bootDriversReady() || (axisValidId(id) && g_boot.axisReady[id]);
+}
+
+static inline String bootFmtMs(uint32_t ms) {
+  return ms ? String(ms) + " ms" : String("pending");
+}
+
+static inline String bootSummary() {
+  return "boot: network " + bootFmtMs(g_boot.netUpMs) + ", drivers " + bootFmtMs(g_boot.drvDoneMs) +
+         ", first command " + bootFmtMs(g_boot.firstCmdMs);
+}
+
+static inline void bootNoteCommand() {
+  if (g_boot.firstCmdMs) return;
+  g_boot.firstCmdMs = millis();
+  Serial.print("First command at "); Serial.print(g_boot.firstCmdMs); Serial.println(" ms after reset");
+}
+
+static inline void bootServiceNetwork() {
+  if (g_boot.net != BOOT_NET_LINK || Ethernet.linkStatus() == LinkOFF) return;
+  bootStartNetwork();
+  g_boot.net     = BOOT_NET_UP;
+  g_boot.netUpMs = millis();
+  Serial.print("Network up at "); Serial.print(g_boot.netUpMs); Serial.println(" ms");
+}
+
+static inline void bootServiceDrivers() {
+  switch (g_boot.drv) {
+    case BOOT_DRV_POWERUP: {
+      if (millis() < DRIVER_POWERUP_MS) return;    // drivers' power-up time, counted from reset
+      g_boot.drvStartMs = millis();
+      const uint32_t baud = busProbeBaud();         // persisted rate first, then factory rate
+      Serial.print("RS-485 at "); Serial.print(baud); Serial.println(" baud");
+      g_boot.next = 0;
+      g_boot.drv  = BOOT_DRV_INIT;
+      return;
+    }
+
+    case BOOT_DRV_INIT: {
+      if (g_boot.next < g_axes.count) {
+        // Same read-compare as initAllDrivers(), one axis per pass; silent axes are retried later
+        const uint8_t id = g_axes.ids[g_boot.next++];
+        const int n = syncDriver(id);
+        if (n < 0) ++g_boot.missing;
+        else if (n) { g_boot.frames += n; ++g_boot.updated; }
+        g_boot.axisReady[id] = true;
+        return;
+      }
+      g_boot.drv       = BOOT_DRV_DONE;
+      g_boot.drvDoneMs = millis();
+      Serial.print("Drivers: ");
+      Serial.print(g_axes.count - g_boot.missing - g_boot.updated); Serial.print(" in sync, ");
+      Serial.print(g_boot.updated); Serial.print(" updated (");
+      Serial.print(g_boot.frames);  Serial.print(" frames), ");
+      Serial.print(g_boot.missing); Serial.print(" no reply (retrying), ");
+      Serial.print(g_boot.drvDoneMs - g_boot.drvStartMs); Serial.print(" ms; ready at ");
+      Serial.print(g_boot.drvDoneMs); Serial.println(" ms");
+      return;
+    }
+
+    case BOOT_DRV_DONE:
+      return;
+  }
+}
+
+static inline void serviceBoot() {
+  static bool announced = false;
+  if (announced) return;
+  bootServiceNetwork();
+  bootServiceDrivers();
+  if (bootNetUp() && bootDriversReady()) {
+    announced = true;
+    Serial.print("Boot complete in "); Serial.print(millis()); Serial.println(" ms");
+    Serial.println("System ready. Commands: Mx,steps | Mx st t|f | Mx,s | stop all | Mx set lo|hi | Mx read | admin on|off | laser on|off | FG / FS");
+  }
+}
+
+#endif // BOOT_H
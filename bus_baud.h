@@ -0,0 +1,211 @@
+#ifndef BUS_BAUD_H
+#define BUS_BAUD_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "output.h"
+#include "dm_556_rs_constants.h"
+#include "driver_io.h"
+#include "motor_init.h"
+#include "nv_store.h"
+#include "runtime_state.h"
+
+/* ── Managed RS-485 baud-rate migration ──────────────────────────────
+   A DM556RS reads its Pr5.22 rate selector at power-up only, so a
+   migration has two halves:
+     "bus baud 115200"
+       1. find the drivers answering at the current rate,
+       2. write the new selector to each, save it (CW_SAVE_ALL_PARAMS)
+          and read it back — still at the current rate,
+       3. persist the new rate, together with the old one, in the NV
+          globals. The bus keeps running at the old rate.
+     power-cycle the drivers and the controller
+       4. busProbeBaud() tries the new rate first; once every driver of
+          the axis table answers there the migration is confirmed. If
+          the bus only answers at the old rate the change is reported as
+          still pending and the old rate is used.
+   If step 2 fails on any driver, every driver found in step 1 is put
+   back on the old selector — at the old rate, and at the new one for a
+   driver that does not answer there — and any driver reachable at
+   neither is named. "bus baud <current rate>" while a change is pending
+   cancels it the same way.
+
+   Saving writes the drivers' flash: this is a commissioning step, not
+   something to run routinely.
+*/
+static uint32_t g_busBaudPending = 0;   // rate the drivers take at their next power-up (0 = none)
+
+struct BaudSel {
+  uint32_t baud;
+  uint16_t sel;
+};
+
+static const BaudSel kBaudTable[] = {
+  {   9600UL, RS485_BAUD_SEL_9600   },
+  {  19200UL, RS485_BAUD_SEL_19200  },
+  {  38400UL, RS485_BAUD_SEL_38400  },
+  {  57600UL, RS485_BAUD_SEL_57600  },
+  { 115200UL, RS485_BAUD_SEL_115200 },
+};
+static const uint8_t kBaudCount = sizeof(kBaudTable) / sizeof(kBaudTable[0]);
+
+static inline int baudSelector(uint32_t baud) {
+  for (uint8_t i = 0; i < kBaudCount; ++i) {
+    if (kBaudTable[i].baud == baud) return kBaudTable[i].sel;
+  }
+  return -1;
+}
+
+// Write the selector and persist it on one driver (at the current host rate)
+static inline bool baudProgram(uint8_t id, uint16_t sel) {
+  uint8_t f[8];
+  buildWriteFrame(id, REG_RS485_BAUD, sel, f);
+  if (!tx(f)) return false;
+  buildWriteFrame(id, REG_CONTROL_WORD, CW_SAVE_ALL_PARAMS, f);
+  return tx(f);
+}
+
+// "bus baud=19200" | "bus baud=19200, 115200 after power cycle"
+static inline String baudStatus() {
+  String s = "bus baud=" + String(g_busBaud);
+  if (g_busBaudPending) s += ", " + String(g_busBaudPending) + " after power cycle";
+  return s;
+}
+
+/* Put every listed driver back on oldSel (and save). They should still
+   answer at oldBaud; one that does not is tried at newBaud in case it
+   took the new rate already. Ends with the host on oldBaud. */
+static inline void baudRollback(const uint8_t *ids, uint8_t n, uint16_t oldSel, uint32_t oldBaud, uint32_t newBaud) {
+  uint8_t missed[MAX_AXES];
+  uint8_t nMissed = 0;
+  busBegin(oldBaud);
+  for (uint8_t i = 0; i < n; ++i) {
+    if (!baudProgram(ids[i], oldSel)) missed[nMissed++] = ids[i];
+  }
+  if (!nMissed) return;
+
+  busBegin(newBaud);
+  for (uint8_t i = 0; i < nMissed; ++i) {
+    if (!baudProgram(missed[i], oldSel)) {
+      printLineBoth("m" + String(missed[i]) + ", baud rollback failed: no reply at " + String(oldBaud) +
+                    " or " + String(newBaud));
+    }
+  }
+  delay(BAUD_SETTLE_MS);
+  busBegin(oldBaud);
+}
+
+// Returns nullptr on success (the new rate is pending until a power cycle), or an error tag
+static inline const char *busMigrateBaud(uint32_t newBaud) {
+  const int newSel = baudSelector(newBaud);
+  const int oldSel = baudSelector(g_busBaud);
+  if (newSel < 0) return "BaudUnsupported";
+  if (oldSel < 0) return "BaudCurrentUnknown";
+  if (newBaud == g_busBaud && !g_busBaudPending) return nullptr;
+
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    if (mById(g_axes.ids[i]).moving) return "busy";
+  }
+  const uint32_t oldBaud = g_busBaud;
+
+  // 1) Drivers answering at the current rate
+  uint8_t present[MAX_AXES];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    uint16_t v;
+    if (readRegs(g_axes.ids[i], REG_RS485_BAUD, 1, &v)) present[n++] = g_axes.ids[i];
+  }
+  if (!n) return "BaudNoDrivers";
+
+  // 2) New selector + save on each, read back; on any failure put all of them back
+  for (uint8_t i = 0; i < n; ++i) {
+    uint16_t v = 0;
+    if (!baudProgram(present[i], (uint16_t)newSel) || !readRegs(present[i], REG_RS485_BAUD, 1, &v) ||
+        v != (uint16_t)newSel) {
+      printLineBoth("m" + String(present[i]) + ", baud write failed");
+      baudRollback(present, n, (uint16_t)oldSel, oldBaud, newBaud);
+      return "BaudWriteFailed";
+    }
+  }
+
+  // 3) Taken at the drivers' next power-up; the controller follows at its next boot
+  g_busBaudPending = (newBaud == oldBaud) ? 0 : newBaud;
+  nvSaveBusBaud(newBaud, g_busBaudPending ? oldBaud : 0);
+  printLineBoth("bus baud: " + String(n) + " drivers programmed for " + String(newBaud) +
+                (g_busBaudPending ? String(", power-cycle drivers and controller") : String("")));
+  return nullptr;
+}
+
+// Boot after a migration: every driver of the axis table must answer at the new rate
+static inline void baudConfirm(uint32_t baud, uint32_t prev) {
+  uint8_t missing = 0;
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    uint16_t v;
+    if (readRegs(g_axes.ids[i], REG_RS485_BAUD, 1, &v)) continue;
+    printLineBoth("m" + String(g_axes.ids[i]) + ", no reply at " + String(baud) + " after baud change");
+    ++missing;
+  }
+  if (missing) return;                        // keep prev: the next boot checks again
+  nvSaveBusBaud(baud, 0);
+  printLineBoth("bus baud=" + String(baud) + " confirmed (was " + String(prev) + ")");
+}
+
+/* First boot (no saved axis table): the scan itself tells whether anyone
+   answers at a rate. Drivers still powering up can miss a scan, so the
+   rates are scanned BUS_SCAN_ATTEMPTS times. If nobody answers at all,
+   every id is used on both ports — the fixed set of drivers the table
+   replaced — and that table is not saved, so the next boot scans again. */
+static inline uint32_t busProbeFirstBoot(const uint32_t *candidates, uint8_t nc) {
+  for (uint8_t a = 0; a < BUS_SCAN_ATTEMPTS && !g_estopPending; ++a) {
+    for (uint8_t c = 0; c < nc; ++c) {
+      bool tried = false;
+      for (uint8_t k = 0; k < c; ++k) tried |= candidates[k] == candidates[c];
+      if (tried) continue;
+      busBegin(candidates[c]);
+      if (busScan()) { nvSaveAxisTable(); return candidates[c]; }
+    }
+  }
+
+  uint8_t port[MAX_AXES + 1];
+  port[0] = AXIS_PORT_NONE;
+  for (uint8_t id = 1; id <= MAX_AXES; ++id) port[id] = AXIS_PORT_A | AXIS_PORT_B;
+  axisTableSet(port);
+  printLineBoth("bus scan: no driver answered, using m1..m" + String(MAX_AXES) +
+                " on both ports (not saved; \"bus scan\" once they are powered)");
+  busBegin(candidates[0]);
+  return candidates[0];
+}
+
+// Boot: find the rate the drivers answer at (persisted rate, rate before an unconfirmed change, factory)
+static inline uint32_t busProbeBaud() {
+  const uint32_t stored = nvLoadBusBaud();
+  const uint32_t prev   = nvLoadBusBaudPrev();
+  const uint32_t candidates[3] = { stored, prev ? prev : stored, MODBUS_BAUD };
+  const uint8_t  probes = g_axes.count < BAUD_PROBE_IDS ? g_axes.count : BAUD_PROBE_IDS;
+
+  if (g_axes.count == 0) return busProbeFirstBoot(candidates, 3);
+
+  for (uint8_t c = 0; c < 3; ++c) {
+    if (candidates[c] == candidates[0] && c > 0) continue;
+    if (c == 2 && candidates[2] == candidates[1]) continue;
+    busBegin(candidates[c]);
+    bool answered = false;
+    for (uint8_t i = 0; i < probes && !answered; ++i) {
+      uint16_t v;
+      answered = readRegs(g_axes.ids[i], REG_RS485_BAUD, 1, &v);
+    }
+    if (!answered) continue;
+    if (prev && candidates[c] != stored) {
+      g_busBaudPending = stored;              // drivers not power-cycled yet
+      printLineBoth("bus baud: drivers still at " + String(candidates[c]) + ", " + String(stored) +
+                    " pending (power-cycle the drivers)");
+    } else if (prev) {
+      baudConfirm(stored, prev);
+    }
+    return candidates[c];
+  }
+  busBegin(stored);             // nobody answered: stay on the persisted rate
+  return stored;
+}
+
+#endif // BUS_BAUD_H
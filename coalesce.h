@@ -0,0 +1,112 @@
+#ifndef COALESCE_H
+#define COALESCE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "output.h"
+#include "axis_table.h"
+#include "driver_io.h"
+#include "runtime_state.h"
+#include "tags.h"
+
+/* ── Move coalescing ─────────────────────────────────────────────────
+   With a window set for an axis ("m<id>, coalesce <ms>", or "coalesce
+   <ms>" for all), a plain move ("m<id>, <steps>" / "MoveTo") is not sent
+   at once: it becomes the axis' pending target and is issued when the
+   window that opened with the first queued move expires. Moves arriving
+   meanwhile fold into it — relative steps add to the pending target,
+   an absolute target replaces it — so a burst of N corrections costs one
+   PR0 load + trigger and one NV save instead of N. The final position is
+   the same; limits and blocks are applied per command against the
+   pending target.
+
+   Anything else addressed to the axis (read, set lo/hi, track, path,
+   home, sync) first issues the pending move; a stop cancels it. Tagged
+   commands are never coalesced (their completion is reported per
+   command). Window 0 (COALESCE_MS default) = send immediately.
+*/
+struct CoalescePending {
+  bool     active;
+  bool     absolute;     // any merged command was absolute: issue as PR0 absolute
+  int32_t  target;       // controller-space target
+  uint32_t dueMs;
+  uint16_t merged;       // commands folded in
+};
+
+struct CoalesceStats {
+  uint32_t moves;        // plain moves received while a window was set
+  uint32_t issued;       // moves actually sent to the driver
+  uint32_t merged;       // moves that never reached the bus on their own
+};
+
+static uint16_t        g_coalesceMs[MAX_AXES + 1];
+static CoalescePending g_coalesce[MAX_AXES + 1];
+static CoalesceStats   g_coalesceStats[MAX_AXES + 1];
+
+static inline void coalesceInit() {
+  for (uint8_t id = 0; id <= MAX_AXES; ++id) g_coalesceMs[id] = COALESCE_MS;
+}
+
+static inline bool coalesceEnabled(uint8_t id) {
+  return g_coalesceMs[id] > 0 && !g_tagCur[0];
+}
+
+static inline bool coalescePending(uint8_t id) {
+  return g_coalesce[id].active;
+}
+
+// Position the next command is relative to: the pending target, if any
+static inline int32_t coalesceBase(uint8_t id) {
+  return g_coalesce[id].active ? g_coalesce[id].target : mById(id).position;
+}
+
+static inline void coalesceQueue(uint8_t id, int32_t target, bool absolute) {
+  CoalescePending &p = g_coalesce[id];
+  ++g_coalesceStats[id].moves;
+  if (!p.active) {
+    p.active   = true;
+    p.absolute = absolute;
+    p.dueMs    = millis() + g_coalesceMs[id];
+    p.merged   = 0;
+  } else {
+    p.absolute = p.absolute || absolute;
+    ++p.merged;
+    ++g_coalesceStats[id].merged;
+  }
+  p.target = target;
+}
+
+static inline String coalesceStatus(uint8_t id) {
+  const CoalescePending &p = g_coalesce[id];
+  return "m" + String(id) + ", queued target=" + String(p.target) +
+         (p.merged ? " (" + String(p.merged) + " merged)" : String(""));
+}
+
+static inline void coalesceCancel(uint8_t id) {
+  g_coalesce[id].active = false;
+}
+
+// Send the pending move now (window expired, or another command needs the axis)
+static inline void coalesceFlush(uint8_t id) {
+  CoalescePending &p = g_coalesce[id];
+  if (!p.active) return;
+  p.active = false;
+
+  MotorState &m = mById(id);
+  if (p.target == m.position) return;        // the burst netted out to nothing
+  ++g_coalesceStats[id].issued;
+  const char *err = p.absolute ? moveMotorAbs(id, p.target)
+                               : (moveMotor(id, p.target - m.position) ? nullptr : "NoAck");
+  if (err) { printLineBoth("m" + String(id) + ", err=" + err); return; }
+  printLineBoth("m" + String(id) + ", pos=" + String(m.position) + " (coalesced)");
+}
+
+static inline void serviceCoalesce() {
+  const uint32_t now = millis();
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const uint8_t id = g_axes.ids[i];
+    if (g_coalesce[id].active && (int32_t)(now - g_coalesce[id].dueMs) >= 0) coalesceFlush(id);
+  }
+}
+
+#endif // COALESCE_H
@@ -20,9 +20,74 @@ static inline IPAddress deviceSubnet()  { return IPAddress(255, 255, 254, 0); }
 #define PORT_NUM            8888
 #define MAX_PACKET_LENGTH   256
 
+/* ── Axis capacity ─────────────────────────────────────────────────── */
+/* Slave ids 1..MAX_AXES; which of them exist comes from the bus scan (axis_table.h) */
+#ifndef MAX_AXES
+#define MAX_AXES            22
+#endif
+#define BUS_SCAN_TIMEOUT_MS 15UL      // per id during "bus scan"
+#define BUS_SCAN_ATTEMPTS   3u        // first boot: scans of every rate before using all ids
+
+/* ── Telemetry stream ("telemetry <period_ms>") ────────────────────── */
+#define TELEMETRY_MIN_MS    20UL      // fastest allowed period
+#define TELEMETRY_KEY_EVERY 10u       // full keyframe every N frames
+
+/* ── Move coalescing ("coalesce <ms>", "m<id>, coalesce <ms>") ────── */
+#define COALESCE_MS         0u        // default window per axis (0 = send every move at once)
+#define COALESCE_MAX_MS     1000u
+
+/* ── Driver parameter snapshots ("drv backup" / "drv restore") ────── */
+#define DRV_DIR             "drv"     // SD directory; one m<id>.bin per axis
+
+/* ── Motion scripts ("script run <name>") ─────────────────────────── */
+#define SCRIPT_DIR          "scripts" // SD directory; scripts are <name>.txt
+#define SCRIPT_NAME_MAX     8u        // 8.3 file names
+#define SCRIPT_CODE_MAX     2048u     // compiled bytecode bytes
+#define SCRIPT_LINE_MAX     160u      // longest source line
+#define SCRIPT_LOOP_DEPTH   4u        // nested repeat ... end
+#define SCRIPT_OPS_PER_PASS 16u       // non-motion ops per loop() pass (a motion op ends the pass)
+
+/* ── Tagged commands ("#<tag> <command>") ─────────────────────────── */
+#define TAG_LEN             12u       // max tag characters
+#define TAG_PENDING_MAX     16u       // tagged motion commands in flight
+
+/* ── Flight recorder ("trace dump") ───────────────────────────────── */
+#ifndef TRACE_ENTRIES
+#define TRACE_ENTRIES       512u      // ring size, power of two (12 bytes each)
+#endif
+
+/* ── Modbus receive timer (mb_rx.h) ───────────────────────────────── */
+/* TC6 drains the bus UARTs into per-port rings and frames replies on the 3.5-char gap */
+#ifndef F_CPU
+#define F_CPU               120000000UL   // SAME53 core clock (GCLK0) for the TC timers
+#endif
+#define MB_RX_TICK_US       100UL     // UART drain period; frame end is known to within this
+#define MB_RX_RING_BYTES    256u      // per port, power of two
+#define MB_RX_FRAMES        16u       // complete frames queued per port, power of two
+
 /* ── RS-485 / Modbus (DM556RS) ────────────────────────────────────── */
 #define SerialPort          Serial1
-#define MODBUS_BAUD         19200UL
+#define MODBUS_BAUD         19200UL   // factory rate; "bus baud" may persist another (NV globals)
+#define BAUD_SETTLE_MS      200UL     // after a driver saves its new rate, before the host switches
+#define BAUD_PROBE_IDS      4u        // drivers tried per candidate rate at boot
+
+/* Write transactions: wait for the slave's echo (FC 0x06/0x10) instead of a fixed guard */
+#define MB_REPLY_TIMEOUT_MS 25UL      // per attempt; an 8-byte echo at 19200 baud takes ~10 ms round trip
+#define MB_WRITE_RETRIES    2u        // extra attempts after a timeout or corrupt echo
+#define MB_READ_TIMEOUT_MS  50UL      // FC 0x03 reply timeout until the slave's timing is learned
+
+/* Adaptive reply timeouts and dead-slave quarantine (slave_health.h) */
+#define MB_RTO_SAMPLES        8u        // replies before a slave's timeout adapts
+#define MB_RTO_MIN_US         2000UL    // least turnaround allowed for on top of wire time
+#define MB_QUARANTINE_MISSES  3u        // unanswered transactions in a row before quarantine
+#define MB_PROBE_MIN_MS       500UL     // first re-probe of a quarantined slave
+#define MB_PROBE_MAX_MS       30000UL   // probe backoff ceiling
+
+/* Emergency stop ("estop", "stop all", optional input pin) */
+#define USE_ESTOP_PIN       0         // 1: ESTOP_PIN at ESTOP_ACTIVE_LEVEL triggers a broadcast quick-stop
+#define ESTOP_PIN           DI6
+#define ESTOP_ACTIVE_LEVEL  LOW       // LOW suits a normally-closed button to 24 V
+#define ESTOP_VERIFY_MS     200UL     // confirm every axis stopped within this, else resend
 
 /* Optional second RS-485 port */
 #define USE_COM0            1
@@ -36,8 +101,40 @@ static inline IPAddress deviceSubnet()  { return IPAddress(255, 255, 254, 0); }
 #define PEAK_CURRENT        10u    /* 0.1A units: 5 = 0.5A */
 #define MICROSTEP           51200u /* steps per revolution */
 
-/* Auto-disable */
+/* Boot timing */
+#define SERIAL_WAIT_MS      0UL    /* wait for USB serial host (0 = don't wait) */
+#define DRIVER_POWERUP_MS   500UL  /* min. time after reset before talking to drivers */
+#define DRIVER_RETRY_MS     2000UL /* retry the config read of a driver that did not answer */
+
+/* Background alarm scan: one REG_ALARM_STATUS read per period, round-robin */
+#define ALARM_SCAN_MS       250UL
+
+/* Register shadow: default staleness bound for "m<id>, read cfg" */
+#define SHADOW_READ_MAX_AGE_MS  60000UL
+
+/* Driver-native homing ("home" command) */
+#define HOME_SPEED_HIGH_RPM 60u
+#define HOME_SPEED_LOW_RPM  10u
+#define HOME_TIMEOUT_MS     180000UL
+
+/* Preloaded PR paths ("path" commands) */
+#define PR_PATH_MAX         16     /* named paths across all axes */
+#define PR_PATH_NAME_LEN    12     /* incl. terminator */
+#define PR_PATH_GAP_MS      50u    /* min. settle for a path: the stop between chained segments */
+
+/* Constant-velocity tracking ("track" command) */
+#define TRACK_MAX_RPM       3000
+#define TRACK_INTEGRATE_MS  10UL   /* how often tracked positions are advanced */
+
+/* Standby hold (axes with hold=standby stay enabled at reduced current) */
+#define STANDBY_CUR_PERCENT 50u    /* % of peak current */
+#define STANDBY_DELAY_MS    500u   /* driver waits this long after motion before reducing */
+
+/* Auto-disable: countdown starts when the axis reports stopped */
 #define DISABLE_TIMEOUT_MS  2000UL
+#define MOTION_POLL_MS      20UL      /* motion-status poll spacing while any axis moves */
+#define MOTION_START_MS     20UL      /* ignore "stopped" this soon after a trigger */
+#define MOTION_MAX_MS       600000UL  /* treat as stopped if a move never reports done */
 
 /* Fan PWM */
 #define FAN_PWM_PIN         IO0
@@ -54,7 +151,21 @@ static inline IPAddress deviceSubnet()  { return IPAddress(255, 255, 254, 0); }
 #define NV_IMAGE_BYTES 2048
 #endif
 
+/* Motion history ("history m<id>"): two alternating append-only files */
+#define HIST_FILE_0         "hist0.bin"
+#define HIST_FILE_1         "hist1.bin"
+#ifndef HIST_FILE_BYTES
+#define HIST_FILE_BYTES     262144UL  /* per file: 16384 records of 16 bytes */
+#endif
+#define HIST_STAGE_RECORDS  64u       /* RAM staging, whole 512-byte sectors */
+#define HIST_IDLE_FLUSH_MS  30000UL   /* append a partial sector after this long */
+#define HIST_QUERY_DEFAULT  10u
+#define HIST_QUERY_MAX      200u
+
 /* ── Laser output ─────────────────────────────────────────────────── */
 #define LASER_PIN           IO1    // drive via laser.h
+#define LASER_BOOT_ON       1      // IO1 level at boot (1 = on; 0 = off, ready for "laser pulse")
+#define LASER_PULSE_MAX_US  10000000UL  // longest "laser pulse" (10 s)
+#define LASER_PULSE_LOG     16u         // pulses kept for "laser pulses"
 
 #endif // CONFIG_H
@@ -0,0 +1,134 @@
+#ifndef COORD_MOVE_H
+#define COORD_MOVE_H
+
+#include <Arduino.h>
+#include <math.h>
+#include "config.h"
+#include "driver_io.h"
+#include "nv_store.h"
+#include "runtime_state.h"
+
+/* ── Coordinated multi-axis moves ────────────────────────────────────
+   "sync m1, 4000 + m2, -1000 + m3, MoveTo 2500" moves every listed axis
+   so they all arrive together. The axis with the longest move time on
+   its own profile sets the shape; every other axis gets the same ramp
+   and cruise times with its velocity scaled by its share of the
+   distance (in revolutions, i.e. steps / microstep). The result is a
+   straight line in joint space. If a scaled axis would exceed its own
+   velocity or ramp rate, the whole move is stretched in time until it
+   fits.
+
+   Trapezoid model of the DM556RS: ramps are given in ms per 1000 RPM,
+   so ramp time = rpm * ramp / 1000 ms. Velocities are integer RPM on
+   the driver, so very short legs of a long move (< a few RPM) arrive
+   slightly early or late.
+
+   Profiles go through the register shadow (only changed registers are
+   sent); all axes are loaded first and the triggers fire back-to-back.
+   The next ordinary move restores the axis' own profile.
+*/
+
+// One requested move of a batch, as parsed ("m<id>, <steps>" or "m<id>, MoveTo <target>")
+struct MoveSpec {
+  uint8_t id;
+  bool    absolute;
+  int32_t value;        // steps, or the absolute target
+};
+
+struct CoordAxis {
+  uint8_t  id;
+  bool     absolute;    // PR0 absolute mode (MoveTo) instead of relative
+  int32_t  steps;       // relative displacement (also set for MoveTo)
+  uint16_t vel;         // planned profile
+  uint16_t accel;
+  uint16_t decel;
+};
+
+// Time (ms) for a trapezoid/triangle move of `rev` revolutions on a profile
+static inline float coordMoveMs(float rev, float rpm, float accel, float decel) {
+  if (rev <= 0.0f || rpm <= 0.0f) return 0.0f;
+  const float ramps  = accel + decel;                       // ms per 1000 RPM, both ramps
+  const float revRamp = rpm * rpm * ramps / (2000.0f * 60000.0f);
+  if (rev >= revRamp) return rev * 60000.0f / rpm + rpm * ramps / 2000.0f;
+  const float peak = sqrtf(rev * 2000.0f * 60000.0f / ramps);
+  return peak * ramps / 1000.0f;
+}
+
+static inline uint16_t coordClampU16(float v) {
+  if (v < 1.0f) return 1;
+  if (v > 65535.0f) return 65535;
+  return (uint16_t)(v + 0.5f);
+}
+
+// Plan the common profile. Returns the predicted move time in ms.
+static inline uint32_t coordPlan(CoordAxis *ax, uint8_t n) {
+  float rev[MAX_AXES];
+  uint8_t lead = 0;
+  float   leadMs = -1.0f;
+  for (uint8_t i = 0; i < n; ++i) {
+    const MotorState &m = mById(ax[i].id);
+    rev[i] = fabsf((float)ax[i].steps) / (float)(m.microstep ? m.microstep : 1);
+    const float t = coordMoveMs(rev[i], m.velocity, m.accel, m.decel);
+    if (t > leadMs) { leadMs = t; lead = i; }
+  }
+
+  const MotorState &L = mById(ax[lead].id);
+  float vLead  = L.velocity;
+  float taLead = vLead * L.accel / 1000.0f;     // ramp times (ms) shared by every axis
+  float tdLead = vLead * L.decel / 1000.0f;
+
+  // Stretch factor: velocity scales by 1/s, ramp rates by 1/s^2
+  float s = 1.0f;
+  for (uint8_t i = 0; i < n; ++i) {
+    if (i == lead || rev[i] <= 0.0f) continue;
+    const MotorState &m = mById(ax[i].id);
+    const float k = rev[i] / rev[lead];
+    const float v = vLead * k;
+    if (m.velocity && v / m.velocity > s) s = v / m.velocity;
+    const float ra = sqrtf(k * (float)m.accel / (float)(L.accel ? L.accel : 1));
+    const float rd = sqrtf(k * (float)m.decel / (float)(L.decel ? L.decel : 1));
+    if (ra > s) s = ra;
+    if (rd > s) s = rd;
+  }
+  vLead  /= s;
+  taLead *= s;
+  tdLead *= s;
+
+  for (uint8_t i = 0; i < n; ++i) {
+    const float v = (rev[lead] > 0.0f) ? vLead * rev[i] / rev[lead] : vLead;
+    ax[i].vel   = coordClampU16(v);
+    ax[i].accel = coordClampU16(taLead * 1000.0f / ax[i].vel);
+    ax[i].decel = coordClampU16(tdLead * 1000.0f / ax[i].vel);
+  }
+  return (uint32_t)(coordMoveMs(rev[lead], vLead, taLead * 1000.0f / vLead, tdLead * 1000.0f / vLead) + 0.5f);
+}
+
+// Execute a planned batch: load every axis, then fire the triggers together.
+// Axes whose driver does not acknowledge are left out; returns the number started.
+static inline uint8_t coordExecute(const CoordAxis *ax, uint8_t n) {
+  bool loaded[MAX_AXES];
+  for (uint8_t i = 0; i < n; ++i) {
+    const CoordAxis &a = ax[i];
+    const MotorState &m = mById(a.id);
+    const bool useAbs = a.absolute && syncAbsOrigin(a.id);     // fall back to relative if it cannot be zeroed
+    const int32_t pos32 = useAbs ? (m.position + a.steps - m.absOrigin) : a.steps;
+    loaded[i] = loadPR0(a.id, useAbs ? PR0_MODE_ABS_POS : PR0_MODE_REL_POS, pos32, a.vel, a.accel, a.decel);
+  }
+
+  for (uint8_t i = 0; i < n; ++i) {
+    if (loaded[i]) loaded[i] = triggerPR0(ax[i].id);
+  }
+
+  uint8_t started = 0;
+  for (uint8_t i = 0; i < n; ++i) {
+    if (!loaded[i]) continue;
+    MotorState &m = mById(ax[i].id);
+    m.lastDir = (ax[i].steps > 0) ? 1 : -1;
+    m.position += ax[i].steps;
+    nvSavePosition(ax[i].id, m.position);
+    ++started;
+  }
+  return started;
+}
+
+#endif // COORD_MOVE_H
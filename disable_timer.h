@@ -0,0 +1,98 @@
+#ifndef DISABLE_TIMER_H
+#define DISABLE_TIMER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/* ── Auto-disable deadlines (indexed min-heap) ───────────────────────
+   One pending deadline per axis, ordered by expiry. The loop only looks
+   at the root, so when nothing is due the check is O(1); arming or
+   cancelling an axis is O(log n). Deadlines are compared with wrap-safe
+   (int32_t)(a - b) arithmetic on millis().
+
+   The heap knows nothing about the bus: monitors.h arms a deadline when
+   an axis reports stopped and drains expired entries; driver_io.h
+   cancels it when a move starts or the axis is disabled.
+*/
+static const uint8_t DT_MAX = MAX_AXES;
+
+struct DisableTimer {
+  uint8_t  n;
+  uint8_t  heap[DT_MAX];          // axis ids, root = earliest deadline
+  uint8_t  slot[DT_MAX + 1];      // heap index + 1 per id, 0 if not armed
+  uint32_t due[DT_MAX + 1];       // deadline per id
+};
+
+static DisableTimer g_disableTimer;
+
+static inline bool dtBefore(uint8_t a, uint8_t b) {
+  return (int32_t)(g_disableTimer.due[a] - g_disableTimer.due[b]) < 0;
+}
+
+static inline void dtSwap(uint8_t i, uint8_t j) {
+  DisableTimer &t = g_disableTimer;
+  uint8_t a = t.heap[i], b = t.heap[j];
+  t.heap[i] = b; t.slot[b] = (uint8_t)(i + 1);
+  t.heap[j] = a; t.slot[a] = (uint8_t)(j + 1);
+}
+
+static inline void dtSiftUp(uint8_t i) {
+  DisableTimer &t = g_disableTimer;
+  while (i > 0) {
+    uint8_t parent = (uint8_t)((i - 1) / 2);
+    if (!dtBefore(t.heap[i], t.heap[parent])) break;
+    dtSwap(i, parent);
+    i = parent;
+  }
+}
+
+static inline void dtSiftDown(uint8_t i) {
+  DisableTimer &t = g_disableTimer;
+  for (;;) {
+    uint8_t l = (uint8_t)(2 * i + 1), r = (uint8_t)(2 * i + 2), m = i;
+    if (l < t.n && dtBefore(t.heap[l], t.heap[m])) m = l;
+    if (r < t.n && dtBefore(t.heap[r], t.heap[m])) m = r;
+    if (m == i) break;
+    dtSwap(i, m);
+    i = m;
+  }
+}
+
+static inline void disableTimerCancel(uint8_t id) {
+  DisableTimer &t = g_disableTimer;
+  if (id < 1 || id > DT_MAX || t.slot[id] == 0) return;
+  uint8_t i = (uint8_t)(t.slot[id] - 1);
+  t.slot[id] = 0;
+  if (--t.n == i) return;
+  uint8_t moved = t.heap[t.n];
+  t.heap[i] = moved;
+  t.slot[moved] = (uint8_t)(i + 1);
+  dtSiftUp(i);
+  dtSiftDown((uint8_t)(t.slot[moved] - 1));
+}
+
+static inline void disableTimerArm(uint8_t id, uint32_t dueMs) {
+  DisableTimer &t = g_disableTimer;
+  if (id < 1 || id > DT_MAX) return;
+  disableTimerCancel(id);
+  t.due[id] = dueMs;
+  t.heap[t.n] = id;
+  t.slot[id] = (uint8_t)(t.n + 1);
+  dtSiftUp(t.n++);
+}
+
+static inline bool disableTimerArmed(uint8_t id) {
+  return id >= 1 && id <= DT_MAX && g_disableTimer.slot[id] != 0;
+}
+
+// Pop the earliest deadline if it has expired; returns its id or 0
+static inline uint8_t disableTimerPopExpired(uint32_t now) {
+  DisableTimer &t = g_disableTimer;
+  if (t.n == 0) return 0;
+  uint8_t id = t.heap[0];
+  if ((int32_t)(now - t.due[id]) < 0) return 0;
+  disableTimerCancel(id);
+  return id;
+}
+
+#endif // DISABLE_TIMER_H
@@ -23,6 +23,14 @@
  *  - Velocity is in RPM; Accel/Decel are in ms per 1000 RPM (lower number ⇒ faster accel).
  */
 
+/* ------------------ Modbus addressing ------------------ */
+/**
+ * MODBUS_BROADCAST_ID
+ *  - Slave address 0: every driver on the bus executes the write; nobody replies.
+ *  - Only meaningful for writes (FC 0x06 / 0x10).
+ */
+constexpr uint8_t MODBUS_BROADCAST_ID = 0x00;
+
 /* ------------------ Modbus Function Codes (RTU PDU: [id][fc][...]) ------------------ */
 constexpr uint8_t FC_READ_HOLDING   = 0x03;  // Read Holding Registers (0x0000..)
 constexpr uint8_t FC_WRITE_SINGLE   = 0x06;  // Write Single Register (Preset Single)
@@ -64,8 +72,14 @@ constexpr uint16_t REG_ALARM_STATUS        = 0x2203; // Pr9.51 — alarm/error s
  * REG_MOTION_STATUS
  *  - Motion status register for polling motor state during move execution.
  *  - 0x0006 = motor moving, 0x0032 = motor stopped, others = idle.
+ *  - Bits: 1 enabled, 2 running, 4 command done, 5 path done, 6 homing done. Bit 6 is set
+ *    once a homing run has found its reference and stays set, so "stopped" is 0x0032 with
+ *    MS_HOME_DONE masked off (motionStopped() in driver_io.h).
  */
 constexpr uint16_t REG_MOTION_STATUS       = 0x1003; // Motion status register
+constexpr uint16_t MS_MOVING               = 0x0006; // as observed on this firmware's drivers
+constexpr uint16_t MS_STOPPED              = 0x0032;
+constexpr uint16_t MS_HOME_DONE            = 0x0040; // homing completed (reference found)
 
 /* ------------- Digital‑Input Function Mapping (write one DI_VAL_* to each) -------------- */
 /**
@@ -149,6 +163,11 @@ constexpr uint16_t REG_STANDBY_CUR_PERCENT = 0x01D3; // Pr5.33 — standby curre
  *  - REG_RS485_DATA_TYPE: data format (usually 8N1). Leave at factory default unless required.
  */
 constexpr uint16_t REG_RS485_BAUD          = 0x01BD; // Pr5.22 — baud rate selector (enum)
+constexpr uint16_t RS485_BAUD_SEL_9600     = 0x0002; // Pr5.22 selector values
+constexpr uint16_t RS485_BAUD_SEL_19200    = 0x0003;
+constexpr uint16_t RS485_BAUD_SEL_38400    = 0x0004;
+constexpr uint16_t RS485_BAUD_SEL_57600    = 0x0005;
+constexpr uint16_t RS485_BAUD_SEL_115200   = 0x0006;
 constexpr uint16_t REG_RS485_ID            = 0x01BF; // Pr5.23 — slave ID
 constexpr uint16_t REG_RS485_DATA_TYPE     = 0x01C1; // Pr5.24 — data format (parity/stop)
 
@@ -160,6 +179,39 @@ constexpr uint16_t REG_RS485_DATA_TYPE     = 0x01C1; // Pr5.24 — data format (
  */
 constexpr uint16_t REG_PR_CONTROL          = 0x6002; // Pr8.02 — path control / software trigger
 
+/**
+ * REG_PR_CONTROL write values (software equivalents of the CTRG / HOME / EMG DI functions).
+ *  - PR_CTRL_TRIGGER_PR0: run PR path 0 (0x0010 + n runs path n).
+ *  - PR_CTRL_HOME: start the driver's homing routine (same as a DI_VAL_TRIGGER_HOME edge).
+ *  - PR_CTRL_QUICK_STOP: decelerate to stop and abort the running path or homing.
+ *  - PR_CTRL_SET_ZERO: define the current position as 0 (absolute moves are relative to it).
+ */
+constexpr uint16_t PR_CTRL_TRIGGER_PR0     = 0x0010; // trigger PR0
+constexpr uint16_t PR_CTRL_HOME            = 0x0020; // start homing
+constexpr uint16_t PR_CTRL_QUICK_STOP      = 0x0040; // quick stop
+constexpr uint16_t PR_CTRL_SET_ZERO        = 0x0021; // current position becomes driver position 0
+
+/**
+ * Homing parameters (Pr8.10 … Pr8.18). Used by the driver when homing is started
+ * via PR_CTRL_HOME or a DI mapped to DI_VAL_TRIGGER_HOME.
+ *  - REG_HOME_MODE: bit0 direction (0 = negative, 1 = positive);
+ *                   bit2 reference (0 = limit switch, 1 = origin switch on a DI_VAL_ORG_SWITCH input).
+ *  - REG_HOME_POS_HIGH/LOW: position the driver assigns to the home point (signed 32-bit).
+ *  - REG_HOME_SPEED_HIGH/LOW: search speed / creep-off speed in RPM.
+ *  - REG_HOME_ACCEL/DECEL: ms per 1000 RPM.
+ * Bit assignments vary between firmware revisions; confirm in the manual.
+ */
+constexpr uint16_t REG_HOME_MODE           = 0x600A; // Pr8.10 — homing mode
+constexpr uint16_t REG_HOME_POS_HIGH       = 0x600B; // Pr8.11 — home position high word
+constexpr uint16_t REG_HOME_POS_LOW        = 0x600C; // Pr8.12 — home position low word
+constexpr uint16_t REG_HOME_SPEED_HIGH     = 0x600F; // Pr8.15 — homing high speed (RPM)
+constexpr uint16_t REG_HOME_SPEED_LOW      = 0x6010; // Pr8.16 — homing low speed (RPM)
+constexpr uint16_t REG_HOME_ACCEL          = 0x6011; // Pr8.17 — homing accel (ms / 1000 RPM)
+constexpr uint16_t REG_HOME_DECEL          = 0x6012; // Pr8.18 — homing decel (ms / 1000 RPM)
+
+constexpr uint16_t HOME_MODE_DIR_POS       = 0x0001; // search in + direction
+constexpr uint16_t HOME_MODE_ORG_SWITCH    = 0x0004; // reference = origin switch (else limit switch)
+
 /**
  * PR0 block: one profile slot used by this firmware.
  *  - MODE: 0 = relative position, 1 = absolute position, 2 = constant velocity.
@@ -174,6 +226,30 @@ constexpr uint16_t REG_PR0_VELOCITY        = 0x6203; // RPM (0..model max)
 constexpr uint16_t REG_PR0_ACCEL           = 0x6204; // ms per 1000 RPM (accel)
 constexpr uint16_t REG_PR0_DECEL           = 0x6205; // ms per 1000 RPM (decel)
 
+/**
+ * PR0 mode word as written by this firmware.
+ *  - PR0_MODE_REL_POS: position move, relative to the current position (vendor encoding 0x0041).
+ *  - PR0_MODE_ABS_POS: position move to an absolute target in the driver's own position frame.
+ *  - PR0_MODE_VELOCITY: run at REG_PR0_VELOCITY (signed RPM) until stopped; the velocity
+ *    register may be rewritten while running.
+ */
+constexpr uint16_t PR0_MODE_REL_POS        = 0x0041; // relative position move
+constexpr uint16_t PR0_MODE_ABS_POS        = 0x0001; // absolute position move
+constexpr uint16_t PR0_MODE_VELOCITY       = 0x0002; // constant velocity; signed RPM in REG_PR0_VELOCITY
+
+/**
+ * PR path slots PR0..PR15. Slot n occupies 8 registers starting at REG_PR0_MODE + 8*n:
+ *   +0 mode, +1 pos high, +2 pos low, +3 velocity, +4 accel, +5 decel, +6 dwell (ms), +7 reserved.
+ * Mode word extras for chaining: PR_MODE_JUMP enables "jump to path" after this segment
+ * (and its dwell) finishes; the target path number goes in bits 8..13 (PR_MODE_JUMP_SHIFT).
+ * Trigger slot n with REG_PR_CONTROL ← PR_CTRL_TRIGGER_PR0 + n.
+ */
+constexpr uint8_t  PR_SLOT_COUNT           = 16;
+constexpr uint8_t  PR_SLOT_REGS            = 8;
+constexpr uint16_t PR_OFF_DWELL            = 6;      // pause after segment (ms)
+constexpr uint16_t PR_MODE_JUMP            = 0x4000; // chain to another path when done
+constexpr uint8_t  PR_MODE_JUMP_SHIFT      = 8;      // target path number position
+
 /* ---------------- Control Word / Maintenance ----------------------------- */
 /**
  * REG_CONTROL_WORD
@@ -4,9 +4,9 @@
 
 // DM556RS_Frames.h — build-only helpers for Modbus RTU write commands (no I/O)
 // Usage summary for C devs new to these drivers and ClearCore:
-// - These helpers only build 8-byte Modbus RTU ADUs. They do not transmit.
+// - These helpers only build Modbus RTU ADUs (8 bytes, except FC 0x10). They do not transmit.
 // - You must call Serial1.write(out, 8) (or your transport) and enforce RS-485 silent time.
-// - Function code used here is 0x06 (Write Single Register) only.
+// - Function codes used here: 0x06 (Write Single Register), 0x10 (Write Multiple), 0x03 (read request).
 // - In the Modbus RTU ADU, addresses/data are big-endian; CRC is LSB-first on the wire.
 // - For position moves, PR0 uses a signed 32-bit step target split into two 16-bit words.
 
@@ -51,6 +51,49 @@ inline void buildWriteFrame(uint8_t id, uint16_t reg, uint16_t data, uint8_t *ou
     out[7] = crc >> 8;                 // CRC high byte
 }
 
+// Build a FC 0x03 (Read Holding Registers) request frame for `count` consecutive registers.
+// The reply is 5 + 2*count bytes: id, 0x03, byteCount, data (big-endian words), CRC lo, CRC hi.
+// out must hold at least 8 bytes.
+inline void buildReadFrame(uint8_t id, uint16_t reg, uint16_t count, uint8_t *out) {
+    out[0] = id;
+    out[1] = FC_READ_HOLDING;          // function 0x03
+    out[2] = MB_HIBYTE(reg);
+    out[3] = MB_LOBYTE(reg);
+    out[4] = MB_HIBYTE(count);
+    out[5] = MB_LOBYTE(count);
+    uint16_t crc = modbusCRC(out, 6);
+    out[6] = crc & 0xFF;
+    out[7] = crc >> 8;
+}
+
+// Build a FC 0x10 (Write Multiple Registers) request frame for `count` consecutive registers.
+// Frame layout (9 + 2*count bytes):
+//   id, 0x10, regHi, regLo, countHi, countLo, byteCount, data (big-endian words), CRC lo, CRC hi
+// The slave replies with an 8-byte echo of id/fc/reg/count.
+// out must hold at least MB_WRITE_MULTI_FRAME_MAX bytes. Returns the frame length.
+constexpr uint8_t MB_WRITE_MULTI_MAX       = 16;
+constexpr uint8_t MB_WRITE_MULTI_FRAME_MAX = 9 + 2 * MB_WRITE_MULTI_MAX;
+
+inline uint8_t buildWriteMultipleFrame(uint8_t id, uint16_t reg, uint8_t count, const uint16_t *vals, uint8_t *out) {
+    if (count > MB_WRITE_MULTI_MAX) count = MB_WRITE_MULTI_MAX;
+    out[0] = id;
+    out[1] = FC_WRITE_MULTIPLE;        // function 0x10
+    out[2] = MB_HIBYTE(reg);
+    out[3] = MB_LOBYTE(reg);
+    out[4] = 0x00;
+    out[5] = count;
+    out[6] = (uint8_t)(2 * count);
+    for (uint8_t i = 0; i < count; ++i) {
+        out[7 + 2 * i] = MB_HIBYTE(vals[i]);
+        out[8 + 2 * i] = MB_LOBYTE(vals[i]);
+    }
+    uint8_t n = (uint8_t)(7 + 2 * count);
+    uint16_t crc = modbusCRC(out, n);
+    out[n]     = crc & 0xFF;
+    out[n + 1] = crc >> 8;
+    return (uint8_t)(n + 2);
+}
+
 // Convenience: software enable via REG_FORCE_ENABLE (bypasses DI mapping).
 // Writes 0x0001 (enable). No response parsing is performed here.
 inline void buildEnableFrame (uint8_t id, uint8_t *out) { buildWriteFrame(id, REG_FORCE_ENABLE, 0x0001, out); }
@@ -61,7 +104,7 @@ inline void buildDisableFrame(uint8_t id, uint8_t *out) { buildWriteFrame(id, RE
 
 // Configure PR0 mode to "relative position" per vendor encoding (0x0041).
 // Leaves other PR0 parameters unchanged (velocity/accel/decel/position).
-inline void buildPR0ModeRelFrame(uint8_t id, uint8_t *out) { buildWriteFrame(id, REG_PR0_MODE, 0x0041, out); }
+inline void buildPR0ModeRelFrame(uint8_t id, uint8_t *out) { buildWriteFrame(id, REG_PR0_MODE, PR0_MODE_REL_POS, out); }
 
 // Set PR0 velocity in RPM (range is model-specific; see manual).
 inline void buildPR0VelocityFrame(uint8_t id, uint16_t rpm, uint8_t *out) { buildWriteFrame(id, REG_PR0_VELOCITY, rpm, out); }
@@ -97,7 +140,42 @@ inline void buildPR0PositionFrames(uint8_t id, int32_t steps32, uint8_t *outHi,
 // Build a software trigger frame to execute the programmed PR path.
 // Writes 0x0010 to REG_PR_CONTROL (vendor "CTRG" bit pattern).
 // Use either this software trigger or a DI mapped to CTRG, not both simultaneously.
-inline void buildTriggerFrame(uint8_t id, uint8_t *out) { buildWriteFrame(id, REG_PR_CONTROL, 0x0010, out); }
+inline void buildTriggerFrame(uint8_t id, uint8_t *out) { buildWriteFrame(id, REG_PR_CONTROL, PR_CTRL_TRIGGER_PR0, out); }
+
+// First register of PR path slot n (0..15).
+inline uint16_t prSlotReg(uint8_t slot) { return REG_PR0_MODE + (uint16_t)slot * PR_SLOT_REGS; }
+
+// Build the full 8-register block for PR slot n as one FC 0x10 frame (25 bytes).
+// mode is a PR mode word (e.g. PR0_MODE_REL_POS); pass next = 0 to end the path,
+// or 1..15 to jump to that slot after this segment's dwell.
+// out must hold at least MB_WRITE_MULTI_FRAME_MAX bytes. Returns the frame length.
+inline uint8_t buildPRSlotFrame(uint8_t id, uint8_t slot, uint16_t mode, int32_t pos32,
+                                uint16_t rpm, uint16_t accel, uint16_t decel, uint16_t dwellMs,
+                                uint8_t next, uint8_t *out) {
+    if (next) mode = (uint16_t)(mode | PR_MODE_JUMP | ((uint16_t)(next & 0x3F) << PR_MODE_JUMP_SHIFT));
+    const uint16_t blk[PR_SLOT_REGS] = {
+        mode,
+        static_cast<uint16_t>((pos32 >> 16) & 0xFFFF),
+        static_cast<uint16_t>( pos32        & 0xFFFF),
+        rpm, accel, decel, dwellMs, 0
+    };
+    return buildWriteMultipleFrame(id, prSlotReg(slot), PR_SLOT_REGS, blk, out);
+}
+
+// Run PR path slot n (0 = the PR0 slot used for single moves).
+inline void buildTriggerPathFrame(uint8_t id, uint8_t slot, uint8_t *out) {
+    buildWriteFrame(id, REG_PR_CONTROL, (uint16_t)(PR_CTRL_TRIGGER_PR0 + slot), out);
+}
+
+// Start the driver's homing routine (software DI_VAL_TRIGGER_HOME). Homing parameters
+// (REG_HOME_*) must already be set.
+inline void buildHomeFrame(uint8_t id, uint8_t *out) { buildWriteFrame(id, REG_PR_CONTROL, PR_CTRL_HOME, out); }
+
+// Make the driver's current position its absolute zero (reference for PR0_MODE_ABS_POS).
+inline void buildSetZeroFrame(uint8_t id, uint8_t *out) { buildWriteFrame(id, REG_PR_CONTROL, PR_CTRL_SET_ZERO, out); }
+
+// Quick stop: decelerate and abort the running PR path or homing.
+inline void buildQuickStopFrame(uint8_t id, uint8_t *out) { buildWriteFrame(id, REG_PR_CONTROL, PR_CTRL_QUICK_STOP, out); }
 
-// Extend with additional builders as required (e.g., FC 0x10 multi-write, jog, homing).
+// Extend with additional builders as required (e.g., jog).
 // Keep signatures and behavior stable so existing callers remain compatible.
@@ -3,119 +3,515 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "output.h"
 #include "dm_556_rs_constants.h"
 #include "dm_556_rs_frames.h"
+#include "driver_shadow.h"
+#include "disable_timer.h"
+#include "axis_table.h"
 #include "runtime_state.h"
 #include "nv_store.h"
+#include "trace.h"
+#include "history.h"
+#include "tags.h"
+#include "mb_rx.h"
+#include "slave_health.h"
 
 // Provided by main.ino
 MotorState &mById(uint8_t id);
 
 /* ── Dual-port helpers ────────────────────────────────────────────── */
-static inline void txPort(HardwareSerial &p, uint8_t *buf) { p.write(buf, 8); }
-static inline int  readAvail(HardwareSerial &p)           { return p.available(); }
-static inline int  readBytes7(HardwareSerial &p, uint8_t *r){ return p.readBytes(r, 7); }
-static inline void flushInput(HardwareSerial &p)          { while (p.available()) p.read(); }
-
-/* ── 8-byte TX with guard ─────────────────────────────────────────── */
-static inline void tx(uint8_t *buf) {
-  txPort(SerialPortA, buf);
+static inline void txPort(HardwareSerial &p, const uint8_t *buf, size_t len) { p.write(buf, len); }
+
+// Before a request: drop whatever complete frames are still queued (mb_rx.h)
+static inline void flushBoth() {
+  mbRxDiscard();
+}
+
+// Send on the bus the slave was found on (both buses for broadcasts / unknown ids)
+static inline void sendFrame(const uint8_t *buf, size_t len) {
+  traceTx(buf);
+  const uint8_t mask = axisPortMask(buf[0]);
+  if (mask & AXIS_PORT_A) txPort(SerialPortA, buf, len);
 #if USE_COM0
-  txPort(SerialPortB, buf);
+  if (mask & AXIS_PORT_B) txPort(SerialPortB, buf, len);
 #endif
-  delay(30);
+}
+
+// Current host UART rate (set by busBegin; see bus_baud.h for migration)
+static uint32_t g_busBaud = MODBUS_BAUD;
+
+// Modbus RTU silent interval (3.5 characters, fixed 1.75 ms above 19200 baud)
+static inline uint32_t mbFrameGapUs() {
+  return (g_busBaud > 19200UL) ? 1750UL : (38500000UL / g_busBaud);
+}
+
+static inline void busBegin(uint32_t baud) {
+  SerialPortA.begin(baud);
+#if USE_COM0
+  SerialPortB.begin(baud);
+#endif
+  g_busBaud = baud;
+  mbRxReset(mbFrameGapUs());
+  healthReset();                  // timings learned at the old rate no longer apply
+}
+
+// Time `bytes` characters take on the wire (11 bits each, as for the silent interval)
+static inline uint32_t mbWireUs(uint16_t bytes) {
+  return (uint32_t)bytes * 11000000UL / g_busBaud;
+}
+
+/* After a frame that gets no reply (broadcast): the frame itself is
+   still leaving the UART buffer, then the silent interval must pass
+   before the next frame, or the drivers read both as one bad frame. */
+static inline uint32_t mbNoReplyGapUs(uint16_t len) {
+  return mbWireUs(len) + mbFrameGapUs();
+}
+
+/* Reply timeout for one transaction: both frames on the wire, the silent
+   interval that closes the reply, and the slave's learned turnaround
+   (slave_health.h). Never longer than the fixed coldMs. */
+static inline uint32_t mbReplyTimeoutUs(uint8_t id, uint8_t reqLen, uint8_t replyLen, uint32_t coldMs) {
+  const uint32_t coldUs = coldMs * 1000UL;
+  const uint32_t t = mbWireUs(reqLen + replyLen) + mbFrameGapUs() + MB_RX_TICK_US + healthTurnaroundUs(id, coldUs);
+  return t < coldUs ? t : coldUs;
+}
+
+// Slave turnaround seen in a transaction that took elapsedUs from send to reply
+static inline int32_t mbTurnaroundUs(uint32_t elapsedUs, uint8_t reqLen, uint8_t replyLen) {
+  const uint32_t fixedUs = mbWireUs(reqLen + replyLen) + mbFrameGapUs();
+  return elapsedUs > fixedUs ? (int32_t)(elapsedUs - fixedUs) : 0;
+}
+
+/* ── Per-slave bus statistics ("bus stats") ──────────────────────────── */
+struct BusStats {
+  uint32_t writes;       // write transactions issued
+  uint32_t retries;      // extra attempts
+  uint32_t failures;     // writes that never got a valid echo
+  uint32_t exceptions;   // Modbus exception replies
+  uint32_t reads;
+  uint32_t readFails;
+  uint32_t skipped;      // transactions not sent: slave quarantined
+  uint8_t  lastExc;      // last exception code
+};
+
+static BusStats g_busStats[MAX_AXES + 1];
+
+enum MbResult : uint8_t { MB_OK = 0, MB_TIMEOUT, MB_BAD_FRAME, MB_EXCEPTION, MB_ABORTED };
+
+/* Emergency stop requested (estop.h: pin interrupt or command). While set,
+   reply waits end at once (MB_ABORTED) and no new transaction starts, so
+   the main loop gets back to serviceEstop() within microseconds. */
+static volatile bool g_estopPending = false;
+
+/* ── Reply receive (whichever bus answers) ────────────────────────────
+   Takes complete, CRC-checked frames from the receive rings (mb_rx.h) as
+   they close, on either port. Frames from another slave or for another
+   function code (late replies to earlier requests) are counted as stray
+   and skipped. A 5-byte exception is MB_EXCEPTION with the code in r[2];
+   a reply of any length other than `want` or a corrupt frame is
+   MB_BAD_FRAME. portOut (optional) receives the AXIS_PORT_* the reply
+   came in on.
+*/
+static inline MbResult mbReceiveFrame(uint8_t id, uint8_t fc, uint8_t *r, uint8_t want, uint32_t timeoutUs,
+                                      uint8_t *portOut) {
+  const uint32_t t0 = micros();
+  uint8_t f[MB_RX_FRAME_MAX];
+  uint8_t len = 0;
+  while (micros() - t0 <= timeoutUs && !g_estopPending) {
+    for (uint8_t k = 0; k < MB_RX_PORTS; ++k) {
+      const MbRxPop got = mbRxPop(g_mbRx[k], f, len);
+      if (got == MBRX_NONE) continue;
+      if (portOut) *portOut = mbRxPortMask(k);
+      if (got == MBRX_BAD) return MB_BAD_FRAME;
+      if (f[0] != id || (f[1] & 0x7F) != fc) { ++g_mbRx[k].stats.stray; continue; }
+
+      memcpy(r, f, len < want ? len : want);
+      if (f[1] & 0x80) return len == 5 ? MB_EXCEPTION : MB_BAD_FRAME;
+      return len == want ? MB_OK : MB_BAD_FRAME;
+    }
+  }
+  return g_estopPending ? MB_ABORTED : MB_TIMEOUT;
+}
+
+static inline MbResult mbReceive(uint8_t id, uint8_t fc, uint8_t *r, uint8_t want, uint32_t timeoutUs,
+                                 uint8_t *portOut = nullptr) {
+  const MbResult res = mbReceiveFrame(id, fc, r, want, timeoutUs, portOut);
+  switch (res) {
+    case MB_OK:        traceRecord(TR_RX_OK, id, fc, fc == FC_READ_HOLDING ? (uint32_t)((r[3] << 8) | r[4]) : 0); break;
+    case MB_TIMEOUT:   traceRecord(TR_RX_TIMEOUT, id, fc); break;
+    case MB_EXCEPTION: traceRecord(TR_RX_EXC, id, fc, r[2]); break;
+    case MB_ABORTED:   break;
+    default:           traceRecord(TR_RX_BAD, id, fc); break;
+  }
+  return res;
+}
+
+static inline void busReportFailure(uint8_t id, const uint8_t *req, MbResult res, uint8_t exc) {
+  const uint16_t reg = (uint16_t(req[2]) << 8) | req[3];
+  String s = "m" + String(id) + ", bus: write 0x" + String(reg, HEX) + " failed (" +
+             (res == MB_EXCEPTION ? "exception " + String(exc) : String("no echo")) + ")";
+  printLineBoth(s);
+}
+
+/* ── Write transaction (FC 0x06 / FC 0x10) ────────────────────────────
+   Sends the frame on both buses and waits for the slave's response: an
+   exact echo for FC 0x06, slave/fc/address/quantity for FC 0x10. The
+   reply is only handed over once the silent interval after it has
+   passed (mb_rx.h), so the next frame may follow at once and a
+   write costs one round trip (~10 ms at 19200 baud) instead of a fixed
+   30 ms, and the echoes no longer pile up in the UARTs. Timeouts and
+   corrupt echoes are retried MB_WRITE_RETRIES times; exceptions are not
+   (the slave rejected the request). Writes that start motion (PR
+   trigger, home) are sent once: if only the echo was lost, a resend
+   would run the move again. For those the motion status is read back
+   instead; a driver that is moving counts as acknowledged, anything
+   else is reported as unknown. Broadcasts (id 0) get no reply and
+   only wait out their wire time and the silent interval. Returns true
+   once the slave has acknowledged; failures are counted per slave and
+   reported.
+*/
+static inline void driverStateLost(uint8_t id);
+static inline bool readRegs(uint8_t id, uint16_t reg, uint8_t count, uint16_t *out);
+
+// REG_PR_CONTROL <- trigger PR n / home: not safe to repeat
+static inline bool mbStartsMotion(const uint8_t *buf) {
+  if (buf[1] != FC_WRITE_SINGLE) return false;
+  const uint16_t reg = (uint16_t(buf[2]) << 8) | buf[3];
+  const uint16_t val = (uint16_t(buf[4]) << 8) | buf[5];
+  return reg == REG_PR_CONTROL &&
+         (val == PR_CTRL_HOME || (val >= PR_CTRL_TRIGGER_PR0 && val < PR_CTRL_TRIGGER_PR0 + PR_SLOT_COUNT));
+}
+
+// A motion start whose echo never came (or came corrupt): look, do not resend
+static inline bool txStartUnconfirmed(uint8_t id, const uint8_t *buf) {
+  const String what = "m" + String(id) + ", bus: write 0x" +
+                      String((uint16_t(buf[2]) << 8) | buf[3], HEX) + " not echoed, not resent: ";
+  uint16_t ms;
+  if (!readRegs(id, REG_MOTION_STATUS, 1, &ms)) {   // counts as a timeout itself
+    printLineBoth(what + "no status reply, result unknown");
+    return false;
+  }
+  if ((ms & ~MS_HOME_DONE) == MS_MOVING) {
+    printLineBoth(what + "driver is moving, taken as started");
+    return true;
+  }
+  printLineBoth(what + "driver not moving (status 0x" + String(ms, HEX) + "), result unknown");
+  return false;
+}
+
+static inline bool tx(const uint8_t *buf, size_t len = 8) {
+  if (g_estopPending) return false;           // estop preempts everything queued behind it
+  const uint8_t id = buf[0];
+  if (id == MODBUS_BROADCAST_ID) {
+    flushBoth();
+    sendFrame(buf, len);
+    delayMicroseconds(mbNoReplyGapUs(len));
+    return true;
+  }
+
+  BusStats &st = g_busStats[id <= MAX_AXES ? id : 0];
+  if (!healthAllow(id)) { ++st.skipped; return false; }   // quarantined, no probe due
+  ++st.writes;
+  uint8_t  r[8] = { 0 };
+  MbResult res = MB_TIMEOUT;
+  const bool     once      = mbStartsMotion(buf);
+  const uint8_t  retries   = (healthQuarantined(id) || once) ? 0 : MB_WRITE_RETRIES;   // a probe is one attempt
+  const uint32_t timeoutUs = mbReplyTimeoutUs(id, len, 8, MB_REPLY_TIMEOUT_MS);
+  for (uint8_t attempt = 0; attempt <= retries; ++attempt) {
+    if (attempt) ++st.retries;
+    flushBoth();
+    const uint32_t t0 = micros();
+    sendFrame(buf, len);
+    res = mbReceive(id, buf[1], r, 8, timeoutUs);
+    if (res == MB_ABORTED) return false;      // not the slave's fault: no stats, no state loss
+    if (res != MB_TIMEOUT) healthNoteReply(id, res == MB_OK ? mbTurnaroundUs(micros() - t0, len, 8) : -1);
+    if (res == MB_OK && memcmp(r, buf, 6) != 0) res = MB_BAD_FRAME;   // FC 0x10 echoes addr + qty only
+    if (res == MB_OK || res == MB_EXCEPTION) break;
+  }
+  if (res == MB_OK) return true;
+
+  ++st.failures;
+  if (res == MB_EXCEPTION) { ++st.exceptions; st.lastExc = r[2]; }
+  else if (once) return txStartUnconfirmed(id, buf);
+  busReportFailure(id, buf, res, r[2]);
+  if (res == MB_TIMEOUT && id <= MAX_AXES) {
+    driverStateLost(id);    // silent slave: may have been power-cycled
+    healthNoteTimeout(id);
+  }
+  return false;
 }
 
 /* ── Driver ops ───────────────────────────────────────────────────── */
-static inline void enableMotorHW(uint8_t id) {
-  uint8_t f[8]; buildEnableFrame(id, f); tx(f);
-  mById(id).enabled = true;
+static inline bool enableMotorHW(uint8_t id) {
+  uint8_t f[8]; buildEnableFrame(id, f);
+  mById(id).enabled = tx(f);
+  return mById(id).enabled;
 }
 static inline void disableMotorHW(uint8_t id) {
+  traceRecord(TR_DISABLE, id, 0);
   uint8_t f[8]; buildDisableFrame(id, f); tx(f);
   mById(id).enabled = false;
+  disableTimerCancel(id);
+}
+
+// Broadcast disable: one frame, no replies; every driver on both buses drops its enable
+static inline void disableAllHW() {
+  traceRecord(TR_DISABLE, MODBUS_BROADCAST_ID, 1);
+  uint8_t f[8]; buildDisableFrame(MODBUS_BROADCAST_ID, f); tx(f);
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const uint8_t id = g_axes.ids[i];
+    mById(id).enabled = false;
+    disableTimerCancel(id);
+  }
+}
+
+/* ── Shadowed writes (see driver_shadow.h) ───────────────────────────
+   Registers whose shadow already holds the requested value are not
+   sent. For a run of consecutive registers, the span from the first to
+   the last changed register goes out as one FC 0x10 frame (or FC 0x06
+   if only one changed). Registers the shadow does not mirror are always
+   written. The shadow takes the new values only once the slave has
+   echoed the write; a failed write forgets them so the next call
+   re-sends. Return value is the number of frames sent.
+*/
+static inline uint8_t writeRegsShadowed(uint8_t id, uint16_t reg, uint8_t count, const uint16_t *vals) {
+  int8_t first = -1, last = -1;
+  for (uint8_t i = 0; i < count; ++i) {
+    if (!shadowMatches(id, reg + i, vals[i])) {
+      if (first < 0) first = (int8_t)i;
+      last = (int8_t)i;
+    }
+  }
+  if (first < 0) return 0;
+
+  bool ok;
+  if (first == last) {
+    uint8_t f[8];
+    buildWriteFrame(id, reg + first, vals[first], f);
+    ok = tx(f);
+  } else {
+    uint8_t f[MB_WRITE_MULTI_FRAME_MAX];
+    uint8_t n = buildWriteMultipleFrame(id, reg + first, (uint8_t)(last - first + 1), vals + first, f);
+    ok = tx(f, n);
+  }
+  for (int8_t i = first; i <= last; ++i) {
+    if (ok) shadowNote(id, reg + i, vals[i]);
+    else    shadowForget(id, reg + i);
+  }
+  return 1;
 }
-static inline void initDriver(uint8_t id) {
-  uint8_t f[8];
+
+static inline uint8_t writeRegShadowed(uint8_t id, uint16_t reg, uint16_t val) {
+  return writeRegsShadowed(id, reg, 1, &val);
+}
+
+/* ── Driver configuration (microstep, peak, PR0, standby current) ─────
+   Only registers that differ from the shadow are written; vel/accel/
+   decel are adjacent and coalesce into a single frame. Returns frames
+   sent. Call shadowInvalidate(id) first to force a full rewrite.
+*/
+static inline uint8_t initDriver(uint8_t id) {
   MotorState &m = mById(id);
-  
+  uint8_t n = 0;
+
   // Don't enable motor on startup - only configure parameters
-  buildMicrostepFrame(id, m.microstep, f); tx(f);
-  buildPeakCurrentFrame(id, m.peakCurr, f); tx(f);
-  buildPR0ModeRelFrame(id, f);        tx(f);
-  buildPR0VelocityFrame(id, m.velocity, f);  tx(f);
-  buildPR0AccelFrame(id, m.accel, f);   tx(f);
-  buildPR0DecelFrame(id, m.decel, f);   tx(f);
+  n += writeRegShadowed(id, REG_MICROSTEP, m.microstep);
+  n += writeRegShadowed(id, REG_PEAK_CURRENT, m.peakCurr);
+  n += writeRegShadowed(id, REG_PR0_MODE, PR0_MODE_REL_POS);
+  const uint16_t prof[3] = { m.velocity, m.accel, m.decel };
+  n += writeRegsShadowed(id, REG_PR0_VELOCITY, 3, prof);
+
+  // Standby current only matters for axes that stay enabled while idle
+  if (m.holdMode == HOLD_STANDBY) {
+    n += writeRegShadowed(id, REG_STANDBY_DELAY_MS, STANDBY_DELAY_MS);
+    n += writeRegShadowed(id, REG_STANDBY_CUR_PERCENT, m.standbyPct);
+  }
+  return n;
 }
 
-/* ── Enable motor before movement ─────────────────────────────────── */
-static inline void ensureMotorEnabled(uint8_t id) {
+/* ── Driver state lost (power-cycle suspected, or alarm) ──────────────
+   Its registers and absolute position frame are unknown: drop the
+   shadow and re-zero the driver before the next absolute move. One
+   missed reply does not mean the driver dropped its enable, so a
+   hold=disable axis keeps its auto-disable deadline (the disable still
+   goes out). Only hold=standby axes, which skip the enable frame on
+   moves, forget their enable flag so the next move re-sends it.
+*/
+static uint32_t g_driverEpoch[MAX_AXES + 1];  // bumps on every state loss (PR slots uploaded earlier are gone)
+
+static inline void driverStateLost(uint8_t id) {
   MotorState &m = mById(id);
-  if (!m.enabled) {
-    enableMotorHW(id);
+  ++g_driverEpoch[id];
+  shadowInvalidate(id);
+  m.absSynced = false;
+  if (m.holdMode == HOLD_STANDBY) m.enabled = false;
+}
+
+/* ── Enable motor before movement ───────────────────────────────────
+   hold=standby axes that are already enabled skip the frame (their
+   flag is cleared by driverStateLost() after a bus error or alarm);
+   all others get one acknowledged enable frame per move.
+*/
+static inline bool ensureMotorEnabled(uint8_t id) {
+  const MotorState &m = mById(id);
+  if (m.holdMode == HOLD_STANDBY && m.enabled) return true;
+  return enableMotorHW(id);
+}
+
+/* ── Multi-register read (FC 0x03) — dual-bus ─────────────────────────
+   Reads `count` consecutive registers into out[]. Returns false on
+   timeout, exception, wrong slave/function or bad CRC. The reply is
+   consumed as soon as its frame closes, so a healthy slave costs one
+   frame round trip, not the full timeout.
+*/
+static const uint8_t READ_REGS_MAX = 24;
+static_assert(5 + 2 * READ_REGS_MAX <= MB_RX_FRAME_MAX, "a full read reply must fit one receive frame");
+
+static inline bool readRegs(uint8_t id, uint16_t reg, uint8_t count, uint16_t *out) {
+  if (count == 0 || count > READ_REGS_MAX) return false;
+  if (g_estopPending) return false;
+
+  BusStats &st = g_busStats[id <= MAX_AXES ? id : 0];
+  if (!healthAllow(id)) { ++st.skipped; return false; }   // quarantined, no probe due
+
+  const uint8_t want = 5 + 2 * count;
+  uint8_t req[8];
+  buildReadFrame(id, reg, count, req);
+  flushBoth();
+  const uint32_t t0 = micros();
+  sendFrame(req, 8);
+
+  ++st.reads;
+  uint8_t r[5 + 2 * READ_REGS_MAX];
+  const MbResult res = mbReceive(id, FC_READ_HOLDING, r, want, mbReplyTimeoutUs(id, 8, want, MB_READ_TIMEOUT_MS));
+  if (res == MB_ABORTED) return false;
+  if (res == MB_TIMEOUT) {
+    ++st.readFails;
+    driverStateLost(id);    // silent slave: may have been power-cycled
+    healthNoteTimeout(id);
+    return false;
   }
+  healthNoteReply(id, res == MB_OK ? mbTurnaroundUs(micros() - t0, 8, want) : -1);
+  if (res == MB_EXCEPTION) { ++st.readFails; ++st.exceptions; st.lastExc = r[2]; return false; }
+  if (res != MB_OK || r[2] != 2 * count) { ++st.readFails; return false; }
+
+  for (uint8_t i = 0; i < count; ++i) {
+    out[i] = (uint16_t(r[3 + 2 * i]) << 8) | r[4 + 2 * i];
+    shadowNote(id, reg + i, out[i]);
+  }
+  return true;
 }
 
-/* ── Single-register read (FC 0x03) — dual-bus ────────────────────── */
-static inline uint16_t readReg(uint8_t id, uint16_t reg) {
-  flushInput(SerialPortA);
-#if USE_COM0
-  flushInput(SerialPortB);
-#endif
+/* ── Cached read: answer from the shadow if no older than maxAgeMs ── */
+static inline bool readRegCached(uint8_t id, uint16_t reg, uint32_t maxAgeMs, uint16_t &out) {
+  if (shadowLookup(id, reg, maxAgeMs, out)) return true;
+  return readRegs(id, reg, 1, &out);
+}
 
-  uint8_t req[8] = {id, 0x03, (uint8_t)(reg >> 8), (uint8_t)reg, 0x00, 0x01, 0, 0};
-  uint16_t c = modbusCRC(req, 6);
-  req[6] = c & 0xFF; req[7] = c >> 8;
+/* ── Single-register read (FC 0x03) — returns 0xFFFF on failure ───── */
+static inline uint16_t readReg(uint8_t id, uint16_t reg) {
+  uint16_t v;
+  return readRegs(id, reg, 1, &v) ? v : 0xFFFF;
+}
 
-  SerialPortA.write(req, 8);
-#if USE_COM0
-  SerialPortB.write(req, 8);
-#endif
+/* ── PR0 load + trigger ───────────────────────────────────────────────
+   Mode, position, velocity, accel and decel are adjacent (0x6200..0x6205),
+   so the shadow sends only what changed as a single frame: a mode switch
+   costs nothing when the mode is unchanged, the profile costs nothing
+   unless a coordinated move or a track changed it, and nothing at all is
+   loaded when the same target is sent again. Loading and triggering are
+   split so a coordinated batch can load every axis first and then fire
+   the triggers back-to-back. Both return false if the driver did not
+   acknowledge; nothing is triggered on a half-loaded PR0.
+*/
+static inline bool loadPR0(uint8_t id, uint16_t mode, int32_t pos32,
+                           uint16_t vel, uint16_t accel, uint16_t decel) {
+  if (!ensureMotorEnabled(id)) return false;
 
-  const uint32_t t0 = millis();
-  while (millis() - t0 <= 50) {
-    if (readAvail(SerialPortA) >= 7) {
-      uint8_t r[7]; readBytes7(SerialPortA, r);
-#if USE_COM0
-      flushInput(SerialPortB);
-#endif
-      if (r[0] == id && r[1] == 0x03) return (uint16_t(r[3]) << 8) | r[4];
-      else return 0xFFFF;
-    }
-#if USE_COM0
-    if (readAvail(SerialPortB) >= 7) {
-      uint8_t r[7]; readBytes7(SerialPortB, r);
-      flushInput(SerialPortA);
-      if (r[0] == id && r[1] == 0x03) return (uint16_t(r[3]) << 8) | r[4];
-      else return 0xFFFF;
-    }
-#endif
+  const uint16_t blk[6] = { mode, (uint16_t)((uint32_t)pos32 >> 16), (uint16_t)((uint32_t)pos32 & 0xFFFF),
+                            vel, accel, decel };
+  writeRegsShadowed(id, REG_PR0_MODE, 6, blk);
+  for (uint8_t i = 0; i < 6; ++i) {
+    if (!shadowMatches(id, REG_PR0_MODE + i, blk[i])) return false;   // write not acknowledged
   }
-  return 0xFFFF;
+  return true;
 }
 
-/* ── Relative move using PR0 ──────────────────────────────────────── */
-static inline void moveMotor(uint8_t id, int32_t steps) {
-  // Enable motor before moving
-  ensureMotorEnabled(id);
-  
-  uint8_t hi[8], lo[8], tr[8];
-  buildPR0PositionFrames(id, steps, hi, lo); tx(hi); tx(lo);
-  buildTriggerFrame(id, tr); tx(tr);
+static inline bool triggerPR0(uint8_t id) {
+  uint8_t tr[8];
+  buildTriggerFrame(id, tr);
+  if (!tx(tr)) return false;
 
   MotorState &m = mById(id);
+  historyMoveBegin(id);
+  tagNoteStart(id);
   m.lastMoveMs = millis();
+  m.moving = true;              // auto-disable countdown restarts once the driver reports stopped
+  m.settleMs = 0;
+  m.stopSent = false;
+  disableTimerCancel(id);
+  return true;
+}
+
+static inline bool loadAndTriggerPR0(uint8_t id, uint16_t mode, int32_t pos32) {
+  const MotorState &m = mById(id);
+  return loadPR0(id, mode, pos32, m.velocity, m.accel, m.decel) && triggerPR0(id);
+}
+
+/* ── Relative move using PR0 — false if the driver did not acknowledge ── */
+static inline bool moveMotor(uint8_t id, int32_t steps) {
+  if (!loadAndTriggerPR0(id, PR0_MODE_REL_POS, steps)) return false;
+
+  MotorState &m = mById(id);
   // record last commanded direction
   m.lastDir = (steps > 0) ? 1 : ((steps < 0) ? -1 : m.lastDir);
 
   // Controller-tracked position + SD save
   m.position += steps;
   nvSavePosition(id, m.position);
+  return true;
+}
+
+/* ── Absolute move using PR0 absolute mode ────────────────────────────
+   The driver's position 0 is tied to controller position absOrigin the
+   first time (and after any state loss) by PR_CTRL_SET_ZERO. The target
+   is then written as-is, so re-sending the same command after a timeout
+   cannot double-move. Returns nullptr, "busy" if the reference cannot
+   be set because the axis is still moving, or "NoAck".
+*/
+static inline bool syncAbsOrigin(uint8_t id) {
+  MotorState &m = mById(id);
+  if (m.absSynced) return true;
+  if (m.moving) return false;
+  uint8_t f[8]; buildSetZeroFrame(id, f);
+  if (!tx(f)) return false;
+  m.absOrigin = m.position;
+  m.absSynced = true;
+  return true;
+}
+
+static inline const char *moveMotorAbs(uint8_t id, int32_t target) {
+  MotorState &m = mById(id);
+  if (!syncAbsOrigin(id)) return m.moving ? "busy" : "NoAck";
+
+  if (!loadAndTriggerPR0(id, PR0_MODE_ABS_POS, target - m.absOrigin)) return "NoAck";
+
+  m.lastDir = (target > m.position) ? 1 : ((target < m.position) ? -1 : m.lastDir);
+  m.position = target;
+  nvSavePosition(id, m.position);
+  return nullptr;
 }
 
 /* ── Quick stop (PR control 0x6002 ← 0x0040) ──────────────────────── */
+// A REG_MOTION_STATUS value that means "stopped" (the homing-done bit aside)
+static inline bool motionStopped(uint16_t ms) {
+  return ms != 0xFFFF && (ms & ~MS_HOME_DONE) == MS_STOPPED;
+}
+
 static inline void stopMotor(uint8_t id) {
-  uint8_t f[8]; buildWriteFrame(id, 0x6002, 0x0040, f); tx(f);
+  mById(id).stopSent = true;
+  uint8_t f[8]; buildQuickStopFrame(id, f); tx(f);
 }
 
 #endif // DRIVER_IO_H
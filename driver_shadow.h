@@ -0,0 +1,96 @@
+#ifndef DRIVER_SHADOW_H
+#define DRIVER_SHADOW_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "dm_556_rs_constants.h"
+
+/* ── Per-driver register shadow ──────────────────────────────────────
+   Mirrors the last value each driver acknowledged for the registers
+   this firmware configures (microstep, peak, PR0 block, standby).
+   Writes that would not change a register are suppressed; reads of
+   these registers can be answered from here within a caller-chosen
+   staleness bound.
+
+   A driver's shadow is dropped whenever we may have lost track of its
+   contents: a read timeout (powered down / power-cycled) or an alarm.
+   This header holds the data only; bus I/O lives in driver_io.h.
+*/
+enum ShadowSlot : uint8_t {
+  SH_MICRO = 0,
+  SH_PEAK,
+  SH_PR0_MODE,
+  SH_PR0_POS_HI,
+  SH_PR0_POS_LO,
+  SH_PR0_VEL,
+  SH_PR0_ACCEL,
+  SH_PR0_DECEL,
+  SH_STANDBY_DELAY,
+  SH_STANDBY_CUR,
+  SH_COUNT
+};
+
+static const uint16_t kShadowRegs[SH_COUNT] = {
+  REG_MICROSTEP, REG_PEAK_CURRENT,
+  REG_PR0_MODE, REG_PR0_POS_HIGH, REG_PR0_POS_LOW,
+  REG_PR0_VELOCITY, REG_PR0_ACCEL, REG_PR0_DECEL,
+  REG_STANDBY_DELAY_MS, REG_STANDBY_CUR_PERCENT
+};
+
+struct DriverShadow {
+  uint16_t valid;               // bit per ShadowSlot
+  uint16_t val[SH_COUNT];
+  uint32_t stampMs[SH_COUNT];   // when the value was last acknowledged/read
+};
+
+static DriverShadow g_shadow[MAX_AXES + 1];
+
+static inline int8_t shadowSlot(uint16_t reg) {
+  for (uint8_t i = 0; i < SH_COUNT; ++i) {
+    if (kShadowRegs[i] == reg) return (int8_t)i;
+  }
+  return -1;
+}
+
+static inline void shadowInvalidate(uint8_t id) {
+  if (id < 1 || id > MAX_AXES) return;
+  g_shadow[id].valid = 0;
+}
+
+// Record a value the driver has confirmed (write acknowledged or read back)
+static inline void shadowNote(uint8_t id, uint16_t reg, uint16_t val) {
+  int8_t s = shadowSlot(reg);
+  if (s < 0 || id < 1 || id > MAX_AXES) return;
+  DriverShadow &d = g_shadow[id];
+  d.val[s] = val;
+  d.stampMs[s] = millis();
+  d.valid |= (uint16_t)(1u << s);
+}
+
+// Drop one register (write not acknowledged: driver contents unknown)
+static inline void shadowForget(uint8_t id, uint16_t reg) {
+  int8_t s = shadowSlot(reg);
+  if (s < 0 || id < 1 || id > MAX_AXES) return;
+  g_shadow[id].valid &= (uint16_t)~(1u << s);
+}
+
+// True if the shadow holds `val` for this register (write can be skipped)
+static inline bool shadowMatches(uint8_t id, uint16_t reg, uint16_t val) {
+  int8_t s = shadowSlot(reg);
+  if (s < 0 || id < 1 || id > MAX_AXES) return false;
+  const DriverShadow &d = g_shadow[id];
+  return (d.valid & (1u << s)) && d.val[s] == val;
+}
+
+// Cached value no older than maxAgeMs; false if absent or stale
+static inline bool shadowLookup(uint8_t id, uint16_t reg, uint32_t maxAgeMs, uint16_t &out) {
+  int8_t s = shadowSlot(reg);
+  if (s < 0 || id < 1 || id > MAX_AXES) return false;
+  const DriverShadow &d = g_shadow[id];
+  if (!(d.valid & (1u << s))) return false;
+  if (millis() - d.stampMs[s] > maxAgeMs) return false;
+  out = d.val[s];
+  return true;
+}
+
+#endif // DRIVER_SHADOW_H
@@ -0,0 +1,219 @@
+#ifndef DRV_BACKUP_H
+#define DRV_BACKUP_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include "dm_556_rs_constants.h"
+#include "dm_556_rs_frames.h"
+#include "axis_table.h"
+#include "driver_io.h"
+#include "driver_shadow.h"
+#include "nv_store.h"
+#include "runtime_state.h"
+
+/* ── Driver parameter snapshot ("drv backup" / "drv restore") ────────
+   The configuration of a DM556RS beyond what initDriver() pushes —
+   DI/DO mapping, locked and standby current, inductance, homing setup —
+   is copied register for register into DRV_DIR/m<id>.bin, so a swapped
+   driver gets the same settings back in one command. PR0 is left out:
+   the host rewrites it on every move.
+
+   The set is a few wide spans (DrvBlock below). Pr parameters are
+   register pairs (high word at the even address), so each span starts
+   on a pair and covers whole parameters; a span is read with one FC 0x03
+   and written back with FC 0x10 frames of up to MB_WRITE_MULTI_MAX
+   registers. One axis costs 5 reads to back up, and 6 writes + 5 reads
+   (verification) to restore. Communication settings (slave id, baud,
+   data format) are not part of the set: the replacement must already
+   answer on the bus.
+
+   The file is versioned and carries its own span table, so a file
+   written with a different span set still restores what it contains:
+     DrvFileHeader | DrvBlock[blocks] | uint16 values[regs]
+   with a CRC over everything after the header.
+*/
+struct DrvBlock {
+  uint16_t reg;
+  uint8_t  count;
+  uint8_t  reserved;
+};
+
+static const DrvBlock kDrvBlocks[] = {
+  { 0x0000, 10, 0 },   // Pr0.00..0.04: microstep (0x0001) .. inductance (0x0009)
+  { 0x0144, 24, 0 },   // Pr4.02..4.13: DI1..DI7 and DO1..DO3 function mapping
+  { 0x0190,  8, 0 },   // Pr5.00..5.03: peak current (0x0191) .. locked current % (0x0197)
+  { 0x01D0,  4, 0 },   // Pr5.32..5.33: standby delay (0x01D1), standby current % (0x01D3)
+  { 0x600A,  9, 0 },   // Pr8.10..8.18: homing mode, position, speeds, ramps
+};
+static const uint8_t DRV_BLOCKS = sizeof(kDrvBlocks) / sizeof(kDrvBlocks[0]);
+static const uint8_t DRV_BLOCKS_MAX = 16;     // accepted in a file
+static const uint16_t DRV_REGS_MAX  = 256;
+
+static const uint32_t DRV_MAGIC   = 0x31565244UL;   // "DRV1"
+static const uint16_t DRV_VERSION = 1;
+
+struct DrvFileHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint8_t  id;          // axis the snapshot was taken from
+  uint8_t  blocks;
+  uint16_t regs;        // values following the block table
+  uint16_t crc;         // modbusCRC over block table + values
+};
+
+struct DrvSnapshot {
+  DrvFileHeader hdr;
+  DrvBlock      block[DRV_BLOCKS_MAX];
+  uint16_t      val[DRV_REGS_MAX];
+};
+
+static DrvSnapshot g_drvSnap;                 // one axis at a time
+
+static inline String drvPath(uint8_t id) {
+  return String(DRV_DIR) + "/m" + String(id) + ".bin";
+}
+
+static inline uint16_t drvCrc(const DrvSnapshot &s) {
+  const uint16_t a = modbusCRC((const uint8_t *)s.block, s.hdr.blocks * sizeof(DrvBlock));
+  const uint16_t b = modbusCRC((const uint8_t *)s.val, s.hdr.regs * sizeof(uint16_t));
+  return a ^ b;
+}
+
+// Read one span into out[] in READ_REGS_MAX pieces; false on the first failed read
+static inline bool drvReadSpan(uint8_t id, uint16_t reg, uint8_t count, uint16_t *out) {
+  for (uint8_t i = 0; i < count; ) {
+    const uint8_t n = (count - i > READ_REGS_MAX) ? READ_REGS_MAX : (uint8_t)(count - i);
+    if (!readRegs(id, reg + i, n, out + i)) return false;
+    i += n;
+  }
+  return true;
+}
+
+/* ── Backup ───────────────────────────────────────────────────────── */
+// Returns nullptr or an error tag
+static inline const char *drvBackup(uint8_t id) {
+  if (!nv_sd_ready()) return "NoSD";
+  DrvSnapshot &s = g_drvSnap;
+  s.hdr.magic   = DRV_MAGIC;
+  s.hdr.version = DRV_VERSION;
+  s.hdr.id      = id;
+  s.hdr.blocks  = DRV_BLOCKS;
+  s.hdr.regs    = 0;
+  for (uint8_t b = 0; b < DRV_BLOCKS; ++b) {
+    s.block[b] = kDrvBlocks[b];
+    if (!drvReadSpan(id, s.block[b].reg, s.block[b].count, s.val + s.hdr.regs)) return "NoReply";
+    s.hdr.regs += s.block[b].count;
+  }
+  s.hdr.crc = drvCrc(s);
+
+  if (!SD.exists(DRV_DIR)) SD.mkdir(DRV_DIR);
+  const String path = drvPath(id);
+  SD.remove(path.c_str());
+  File f = SD.open(path.c_str(), FILE_WRITE);
+  if (!f) return "FileOpen";
+  const size_t want = sizeof(DrvFileHeader) + s.hdr.blocks * sizeof(DrvBlock) + s.hdr.regs * sizeof(uint16_t);
+  size_t n = f.write((const uint8_t *)&s.hdr, sizeof(DrvFileHeader));
+  n += f.write((const uint8_t *)s.block, s.hdr.blocks * sizeof(DrvBlock));
+  n += f.write((const uint8_t *)s.val, s.hdr.regs * sizeof(uint16_t));
+  f.close();
+  return n == want ? nullptr : "FileWrite";
+}
+
+/* ── Restore / verify ─────────────────────────────────────────────── */
+static inline const char *drvLoad(uint8_t id) {
+  if (!nv_sd_ready()) return "NoSD";
+  const String path = drvPath(id);
+  File f = SD.open(path.c_str(), FILE_READ);
+  if (!f) return "NoBackup";
+  DrvSnapshot &s = g_drvSnap;
+  bool ok = f.read((uint8_t *)&s.hdr, sizeof(DrvFileHeader)) == (int)sizeof(DrvFileHeader) &&
+            s.hdr.magic == DRV_MAGIC && s.hdr.version == DRV_VERSION &&
+            s.hdr.blocks <= DRV_BLOCKS_MAX && s.hdr.regs <= DRV_REGS_MAX;
+  ok = ok && f.read((uint8_t *)s.block, s.hdr.blocks * sizeof(DrvBlock)) == (int)(s.hdr.blocks * sizeof(DrvBlock));
+  ok = ok && f.read((uint8_t *)s.val, s.hdr.regs * sizeof(uint16_t)) == (int)(s.hdr.regs * sizeof(uint16_t));
+  f.close();
+  if (!ok) return "BadBackup";
+
+  uint16_t sum = 0;
+  for (uint8_t b = 0; b < s.hdr.blocks; ++b) sum += s.block[b].count;
+  if (sum != s.hdr.regs || drvCrc(s) != s.hdr.crc) return "BadBackup";
+  return nullptr;
+}
+
+// Compare the driver with the loaded snapshot; mismatchReg receives the first differing register
+static inline const char *drvVerifyLoaded(uint8_t id, uint16_t &mismatchReg) {
+  const DrvSnapshot &s = g_drvSnap;
+  uint16_t now[DRV_REGS_MAX];
+  uint16_t k = 0;
+  for (uint8_t b = 0; b < s.hdr.blocks; ++b) {
+    if (!drvReadSpan(id, s.block[b].reg, s.block[b].count, now + k)) return "NoReply";
+    for (uint8_t i = 0; i < s.block[b].count; ++i, ++k) {
+      if (now[k] != s.val[k]) { mismatchReg = s.block[b].reg + i; return "Mismatch"; }
+    }
+  }
+  return nullptr;
+}
+
+static inline const char *drvVerify(uint8_t id, uint16_t &mismatchReg) {
+  const char *err = drvLoad(id);
+  return err ? err : drvVerifyLoaded(id, mismatchReg);
+}
+
+// Microstep and peak current are also host settings (initDriver() pushes them at boot): adopt the restored ones
+static inline void drvAdoptParams(uint8_t id) {
+  uint16_t micro = 0, peak = 0;
+  uint8_t  found = 0;
+  const DrvSnapshot &s = g_drvSnap;
+  uint16_t k = 0;
+  for (uint8_t b = 0; b < s.hdr.blocks; ++b) {
+    for (uint8_t i = 0; i < s.block[b].count; ++i, ++k) {
+      const uint16_t reg = s.block[b].reg + i;
+      if (reg == REG_MICROSTEP)    { micro = s.val[k]; found |= 1; }
+      if (reg == REG_PEAK_CURRENT) { peak  = s.val[k]; found |= 2; }
+    }
+  }
+  if (found != 3) return;
+  MotorState &m = mById(id);
+  m.microstep = micro;
+  m.peakCurr  = peak;
+  nvSaveMotorParams(id, m.velocity, m.accel, m.decel, m.peakCurr, m.microstep);
+}
+
+/* Write the snapshot back (FC 0x10 per span, split at MB_WRITE_MULTI_MAX),
+   read everything back to verify, then optionally CW_SAVE_ALL_PARAMS.
+   A snapshot of another axis may be restored (drv restore m<id> from m<src>). */
+static inline const char *drvRestore(uint8_t id, uint8_t srcId, bool save, uint16_t &mismatchReg, uint8_t &frames) {
+  frames = 0;
+  const char *err = drvLoad(srcId);
+  if (err) return err;
+  const DrvSnapshot &s = g_drvSnap;
+
+  uint16_t k = 0;
+  for (uint8_t b = 0; b < s.hdr.blocks; ++b) {
+    for (uint8_t i = 0; i < s.block[b].count; ) {
+      const uint8_t n = (s.block[b].count - i > MB_WRITE_MULTI_MAX) ? MB_WRITE_MULTI_MAX : (uint8_t)(s.block[b].count - i);
+      uint8_t f[MB_WRITE_MULTI_FRAME_MAX];
+      const uint8_t len = buildWriteMultipleFrame(id, s.block[b].reg + i, n, s.val + k, f);
+      ++frames;
+      if (!tx(f, len)) { mismatchReg = s.block[b].reg + i; return "WriteFailed"; }
+      i += n;
+      k += n;
+    }
+  }
+
+  shadowInvalidate(id);                 // the verification reads re-seed it
+  err = drvVerifyLoaded(id, mismatchReg);
+  if (err) return err;
+
+  if (save) {
+    uint8_t f[8];
+    buildWriteFrame(id, REG_CONTROL_WORD, CW_SAVE_ALL_PARAMS, f);
+    ++frames;
+    if (!tx(f)) return "SaveFailed";
+  }
+  drvAdoptParams(id);
+  return nullptr;
+}
+
+#endif // DRV_BACKUP_H
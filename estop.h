@@ -0,0 +1,157 @@
+#ifndef ESTOP_H
+#define ESTOP_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "output.h"
+#include "dm_556_rs_constants.h"
+#include "dm_556_rs_frames.h"
+#include "axis_table.h"
+#include "driver_io.h"
+#include "runtime_state.h"
+#include "tracking.h"
+#include "homing.h"
+#include "monitors.h"
+#include "coalesce.h"
+#include "trace.h"
+#include "script.h"
+
+/* ── Emergency stop ──────────────────────────────────────────────────
+   One broadcast quick-stop frame (REG_PR_CONTROL <- PR_CTRL_QUICK_STOP
+   to slave 0) on both buses halts every driver at once: a single frame
+   time (~5 ms at 19200 baud) instead of one acknowledged write per axis.
+   Nothing else is sent until the frame and the silent interval after it
+   have passed, so no following frame can run into it on the wire.
+
+   Triggers: "estop" / "stop all" (TCP or serial), or the optional input
+   pin (USE_ESTOP_PIN), whose interrupt only raises g_estopPending. That
+   flag makes any reply wait in progress return at once and refuses new
+   transactions (driver_io.h), so the loop reaches serviceEstop() — the
+   first thing it runs — within microseconds, whatever it was doing.
+
+   Afterwards each axis that was moving is read back, one per loop pass;
+   axes still moving after ESTOP_VERIFY_MS get a unicast quick-stop, and
+   the outcome is reported. While the pin stays active, moving axes are
+   stopped again every ESTOP_VERIFY_MS.
+*/
+struct EstopState {
+  bool     verifying;
+  bool     resent;
+  uint8_t  left;                     // axes not yet confirmed stopped
+  uint8_t  next;                     // index into g_axes.ids
+  uint32_t sentMs;                   // broadcast (or unicast resend) time
+  bool     pending[MAX_AXES + 1];    // per id: awaiting stop confirmation
+};
+
+static EstopState           g_estop;
+static const char *volatile g_estopSource = "";
+
+// Request an emergency stop; executed at the top of the next loop pass (or right away by estopExecute)
+static inline void estopTrigger(const char *source) {
+  g_estopSource  = source;
+  g_estopPending = true;
+}
+
+#if USE_ESTOP_PIN
+static void estopIsr() {
+  g_estopSource  = "pin";
+  g_estopPending = true;
+}
+
+static inline bool estopPinActive() {
+  return digitalRead(ESTOP_PIN) == ESTOP_ACTIVE_LEVEL;
+}
+#endif
+
+static inline void estopSetup() {
+#if USE_ESTOP_PIN
+  pinMode(ESTOP_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(ESTOP_PIN), estopIsr, ESTOP_ACTIVE_LEVEL == LOW ? FALLING : RISING);
+#endif
+}
+
+static inline void estopExecute() {
+  uint8_t f[8];
+  buildQuickStopFrame(MODBUS_BROADCAST_ID, f);
+  flushBoth();
+  sendFrame(f, 8);                  // both buses, no reply to wait for
+  delayMicroseconds(mbNoReplyGapUs(8));   // let it leave the UART and close before any next frame
+  g_estop.sentMs = millis();
+  g_estopPending = false;
+  traceRecord(TR_ESTOP, MODBUS_BROADCAST_ID);
+  scriptAbort("estop", false);      // the broadcast already stopped its axes
+  laserDisarm();                    // no exposure after an aborted move
+
+  g_estop.left = 0;
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const uint8_t id = g_axes.ids[i];
+    coalesceCancel(id);
+    if (trackActive(id)) trackStop(id, "estop", false);
+    homingAbort(id);
+    g_estop.pending[id] = mById(id).moving;
+    if (!g_estop.pending[id]) continue;
+    mById(id).stopSent = true;      // its move ends aborted, not done (history, tags)
+    ++g_estop.left;
+  }
+  g_estop.verifying = g_estop.left > 0;
+  g_estop.resent    = false;
+  g_estop.next      = 0;
+  printLineBoth("estop (" + String(g_estopSource) + "): quick-stop broadcast, " +
+                String(g_estop.left) + " axes moving");
+}
+
+static inline void estopVerifyStep() {
+  // Confirm the next unconfirmed axis
+  for (uint8_t k = 0; k < g_axes.count; ++k) {
+    if (g_estop.next >= g_axes.count) g_estop.next = 0;
+    const uint8_t id = g_axes.ids[g_estop.next++];
+    if (!g_estop.pending[id]) continue;
+    if (motionStopped(readReg(id, REG_MOTION_STATUS))) {
+      g_estop.pending[id] = false;
+      --g_estop.left;
+      if (mById(id).moving) onAxisStopped(id, STOP_ABORTED);
+    }
+    break;
+  }
+
+  if (g_estop.left == 0) {
+    g_estop.verifying = false;
+    printLineBoth("estop: all axes stopped, " + String(millis() - g_estop.sentMs) + " ms");
+    return;
+  }
+  if (millis() - g_estop.sentMs < ESTOP_VERIFY_MS) return;
+
+  String s = "estop:";
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const uint8_t id = g_axes.ids[i];
+    if (!g_estop.pending[id]) continue;
+    s += " m" + String(id);
+    if (!g_estop.resent) stopMotor(id);
+  }
+  if (!g_estop.resent) {
+    printLineBoth(s + " still moving, stop resent");
+    g_estop.resent = true;
+    g_estop.sentMs = millis();
+  } else {
+    printLineBoth(s + " did not confirm stop");
+    g_estop.verifying = false;
+  }
+}
+
+// First thing in loop()
+static inline void serviceEstop() {
+  if (g_estopPending) { estopExecute(); return; }
+
+#if USE_ESTOP_PIN
+  // Held input: anything that starts moving is stopped again
+  if (estopPinActive() && !g_estop.verifying && millis() - g_estop.sentMs >= ESTOP_VERIFY_MS) {
+    for (uint8_t i = 0; i < g_axes.count; ++i) {
+      if (mById(g_axes.ids[i]).moving) { estopTrigger("pin held"); return; }
+    }
+  }
+#endif
+
+  if (g_estop.verifying) estopVerifyStep();
+}
+
+#endif // ESTOP_H
@@ -0,0 +1,258 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include "output.h"
+#include "axis_table.h"
+#include "runtime_state.h"
+#include "nv_store.h"
+
+/* ── Motion history (append-only, on SD) ─────────────────────────────
+   One 16-byte record per finished move: end time, commanded steps
+   (controller position change), resulting position, duration and limit
+   events. Records are staged in RAM and written to SD only from the
+   main loop while no axis is moving, normally as whole 512-byte sectors,
+   so a move command never waits on the card. Records that wait longer
+   than HIST_IDLE_FLUSH_MS are appended as they are (no padding), so
+   little is lost at power-off; the next append first fills that sector
+   up to its boundary, keeping full-sector writes aligned. A slow trickle
+   of moves therefore costs 16 bytes of file per move, not a sector.
+
+   Two files alternate (HIST_FILE_0 / HIST_FILE_1). When the active one
+   would exceed HIST_FILE_BYTES, the other is deleted and becomes the
+   active file with the next generation number, so the history holds
+   between one and two files' worth of moves. The active file's size is
+   kept in RAM, so appending does not need to look at it first. Each
+   file starts with a header record carrying its generation; each boot
+   adds a boot record (the time field restarts from 0 there: millis()
+   has no date).
+
+   "history m<id> [n]" reads newest-first: the staged records, then the
+   active file and the older file backwards up to one sector at a time.
+*/
+struct HistRecord {
+  uint32_t endMs;     // millis() when the axis reported stopped
+  int32_t  steps;     // controller position change over the move
+  int32_t  pos;       // controller position after the move
+  uint16_t dur10ms;   // duration in 10 ms units (saturates)
+  uint8_t  id;        // motor id, or one of HIST_ID_*
+  uint8_t  flags;     // HIST_F_*
+};
+static_assert(sizeof(HistRecord) == 16, "history record must stay 16 bytes");
+
+static const uint8_t  HIST_ID_PAD  = 0x00;   // filler (header sector of older files); skipped
+static const uint8_t  HIST_ID_BOOT = 0xFE;   // controller restarted here
+static const uint8_t  HIST_ID_FILE = 0xFF;   // file header, steps = generation
+
+static const uint8_t  HIST_F_BLOCKNEG  = 0x01;   // negative limit engaged at the end
+static const uint8_t  HIST_F_BLOCKPOS  = 0x02;   // positive limit engaged at the end
+static const uint8_t  HIST_F_LIMIT_HIT = 0x04;   // a limit switch changed during the move
+static const uint8_t  HIST_F_TIMEOUT   = 0x08;   // never reported stopped (MOTION_MAX_MS)
+static const uint8_t  HIST_F_ABORTED   = 0x10;   // ended by a quick-stop or the estop
+
+static const uint16_t HIST_SECTOR_BYTES   = 512;
+static const uint8_t  HIST_SECTOR_RECORDS = HIST_SECTOR_BYTES / sizeof(HistRecord);
+static_assert(HIST_STAGE_RECORDS % HIST_SECTOR_RECORDS == 0, "stage whole sectors");
+static_assert(HIST_FILE_BYTES % HIST_SECTOR_BYTES == 0, "history file size must be whole sectors");
+static const uint16_t HIST_REC_BYTES = sizeof(HistRecord);
+
+static const char *const kHistFiles[2] = { HIST_FILE_0, HIST_FILE_1 };
+
+struct HistOpen {
+  bool     open;
+  uint8_t  flags;
+  int32_t  startPos;
+  uint32_t startMs;
+};
+
+static HistRecord g_histStage[HIST_STAGE_RECORDS];
+static uint16_t   g_histCount  = 0;           // staged records (oldest at index 0)
+static uint32_t   g_histLastMs = 0;           // last record staged
+static uint8_t    g_histActive = 0;           // index into kHistFiles
+static uint32_t   g_histGen    = 0;           // generation of the active file
+static uint32_t   g_histSize   = 0;           // bytes in the active file
+static bool       g_histReady  = false;       // SD present and files opened at boot
+static HistOpen   g_histOpen[MAX_AXES + 1];
+
+static inline void historyStage(const HistRecord &r) {
+  if (g_histCount >= HIST_STAGE_RECORDS) {
+    // SD absent or the machine never idles: drop the oldest staged sector
+    memmove(g_histStage, g_histStage + HIST_SECTOR_RECORDS,
+            (HIST_STAGE_RECORDS - HIST_SECTOR_RECORDS) * sizeof(HistRecord));
+    g_histCount -= HIST_SECTOR_RECORDS;
+  }
+  g_histStage[g_histCount++] = r;
+  g_histLastMs = millis();
+}
+
+/* ── Move bookkeeping (called from the motion paths) ─────────────────── */
+static inline void historyMoveBegin(uint8_t id) {
+  HistOpen &h = g_histOpen[id];
+  if (h.open) return;                          // re-trigger while moving: same move
+  h.open     = true;
+  h.flags    = 0;
+  h.startPos = mById(id).position;
+  h.startMs  = millis();
+}
+
+static inline void historyNoteLimit(uint8_t id) {
+  if (g_histOpen[id].open) g_histOpen[id].flags |= HIST_F_LIMIT_HIT;
+}
+
+static inline void historyMoveEnd(uint8_t id, AxisStop how) {
+  HistOpen &h = g_histOpen[id];
+  if (!h.open) return;
+  h.open = false;
+
+  const MotorState &m = mById(id);
+  const uint32_t now = millis();
+  const uint32_t dur = (now - h.startMs) / 10;
+  HistRecord r;
+  r.endMs   = now;
+  r.steps   = m.position - h.startPos;
+  r.pos     = m.position;
+  r.dur10ms = (uint16_t)(dur > 0xFFFF ? 0xFFFF : dur);
+  r.id      = id;
+  r.flags   = (uint8_t)(h.flags | (m.blockNeg ? HIST_F_BLOCKNEG : 0) | (m.blockPos ? HIST_F_BLOCKPOS : 0) |
+                        (how == STOP_TIMEOUT ? HIST_F_TIMEOUT : 0) | (how == STOP_ABORTED ? HIST_F_ABORTED : 0));
+  historyStage(r);
+}
+
+/* ── SD side ─────────────────────────────────────────────────────────── */
+static inline uint32_t historyFileGen(uint8_t which, uint32_t *sizeOut) {
+  *sizeOut = 0;
+  File f = SD.open(kHistFiles[which], FILE_READ);
+  if (!f) return 0;
+  HistRecord r;
+  uint32_t gen = 0;
+  *sizeOut = f.size();
+  if (f.read((uint8_t *)&r, sizeof(r)) == (int)sizeof(r) && r.id == HIST_ID_FILE) gen = (uint32_t)r.steps;
+  f.close();
+  return gen;
+}
+
+static inline bool historyAppend(const HistRecord *recs, uint16_t n) {
+  File f = SD.open(kHistFiles[g_histActive], FILE_WRITE);
+  if (!f) return false;
+  const size_t bytes = (size_t)n * HIST_REC_BYTES;
+  const size_t w = f.write((const uint8_t *)recs, bytes);
+  f.close();
+  if (w != bytes) return false;
+  g_histSize += bytes;
+  return true;
+}
+
+// Switch to the other file: delete it, start it with a header record
+static inline bool historyRotate() {
+  g_histActive ^= 1;
+  ++g_histGen;
+  SD.remove(kHistFiles[g_histActive]);
+  g_histSize = 0;
+
+  HistRecord hdr = {};
+  hdr.id    = HIST_ID_FILE;
+  hdr.steps = (int32_t)g_histGen;
+  return historyAppend(&hdr, 1);
+}
+
+// Boot: pick the newer file, start a new one if it is full or missing
+static inline void historyInit() {
+  if (!nv_sd_ready()) return;
+  uint32_t size[2];
+  const uint32_t gen0 = historyFileGen(0, &size[0]);
+  const uint32_t gen1 = historyFileGen(1, &size[1]);
+  g_histActive = (gen1 > gen0) ? 1 : 0;
+  g_histGen    = (gen1 > gen0) ? gen1 : gen0;
+
+  const uint32_t sz = size[g_histActive];
+  g_histSize = sz;
+  if (g_histGen == 0 || sz % HIST_REC_BYTES != 0 || sz + HIST_SECTOR_BYTES > HIST_FILE_BYTES) {
+    // no history yet, a torn write, or full: continue in a fresh file
+    if (!historyRotate()) return;
+  }
+  g_histReady = true;
+
+  HistRecord boot = {};
+  boot.id = HIST_ID_BOOT;
+  historyStage(boot);
+}
+
+static inline bool historyAnyMoving() {
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    if (mById(g_axes.ids[i]).moving) return true;
+  }
+  return false;
+}
+
+// Main loop: append up to the next sector boundary per call, only while the axes are idle
+static inline void serviceHistory() {
+  if (!g_histReady || g_histCount == 0) return;
+  if (historyAnyMoving()) return;
+
+  uint16_t n = (uint16_t)(HIST_SECTOR_RECORDS - (g_histSize / HIST_REC_BYTES) % HIST_SECTOR_RECORDS);
+  if (g_histCount < n) {
+    if (millis() - g_histLastMs < HIST_IDLE_FLUSH_MS) return;
+    n = g_histCount;                           // idle: append the partial sector as it is
+  }
+  if (g_histSize + (uint32_t)n * HIST_REC_BYTES > HIST_FILE_BYTES) {
+    historyRotate();                           // boundary moved: recount next pass
+    return;
+  }
+
+  if (!historyAppend(g_histStage, n)) return;  // card trouble: keep it staged
+  g_histCount -= n;
+  memmove(g_histStage, g_histStage + n, g_histCount * sizeof(HistRecord));
+}
+
+/* ── Query ("history m<id> [n]") ─────────────────────────────────────── */
+static inline String historyFmt(const HistRecord &r, uint8_t boots) {
+  String lim = (r.flags & HIST_F_BLOCKNEG) ? "neg" : ((r.flags & HIST_F_BLOCKPOS) ? "pos" : "none");
+  String s = "m" + String(r.id) + ", t=" + String(r.endMs) + (boots ? "/boot-" + String(boots) : String("")) +
+             ", steps=" + String(r.steps) + ", pos=" + String(r.pos) +
+             ", dur=" + String((uint32_t)r.dur10ms * 10) + "ms, lim=" + lim;
+  if (r.flags & HIST_F_LIMIT_HIT) s += ", limit hit";
+  if (r.flags & HIST_F_TIMEOUT)   s += ", timeout";
+  if (r.flags & HIST_F_ABORTED)   s += ", aborted";
+  return s;
+}
+
+// Visit records newest-first; returns false once `n` matches were printed
+static inline bool historyVisit(const HistRecord &r, uint8_t id, uint16_t &left, uint8_t &boots) {
+  if (r.id == HIST_ID_BOOT) { ++boots; return true; }
+  if (r.id != id) return true;
+  printLineBoth(historyFmt(r, boots));
+  return --left != 0;
+}
+
+static inline void historyQuery(uint8_t id, uint16_t n) {
+  uint16_t left  = n;
+  uint8_t  boots = 0;             // boot records crossed: t is relative to that boot
+  printLineBoth("m" + String(id) + ", history (newest first)");
+
+  for (int i = (int)g_histCount - 1; i >= 0; --i) {
+    if (!historyVisit(g_histStage[i], id, left, boots)) return;
+  }
+  if (!g_histReady) return;
+
+  HistRecord sec[HIST_SECTOR_RECORDS];
+  for (uint8_t k = 0; k < 2; ++k) {
+    File f = SD.open(kHistFiles[g_histActive ^ k], FILE_READ);
+    if (!f) continue;
+    // Back from the end in sector-aligned chunks (the last one may be partial)
+    uint32_t end = f.size() - f.size() % HIST_REC_BYTES;
+    while (end > 0) {
+      const uint32_t off = (end - 1) & ~(uint32_t)(HIST_SECTOR_BYTES - 1);
+      const int bytes = (int)(end - off);
+      if (!f.seek(off) || f.read((uint8_t *)sec, bytes) != bytes) break;
+      for (int i = bytes / HIST_REC_BYTES - 1; i >= 0; --i) {
+        if (!historyVisit(sec[i], id, left, boots)) { f.close(); return; }
+      }
+      end = off;
+    }
+    f.close();
+  }
+}
+
+#endif // HISTORY_H
@@ -0,0 +1,147 @@
+#ifndef HOMING_H
+#define HOMING_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "output.h"
+#include "driver_io.h"
+#include "alarm_scan.h"
+#include "nv_store.h"
+#include "runtime_state.h"
+
+/* ── Driver-native homing, many axes at once ─────────────────────────
+   "home m1 m5 m7" / "home all" programs the homing parameters on every
+   selected driver, then fires the PR_CTRL_HOME triggers back-to-back so
+   all axes search for their origin switch concurrently. Completion is
+   picked up by the shared move-completion poll (monitors.h) — homing
+   axes are simply flagged `moving` — and serviceHoming() finishes each
+   axis as it stops. Only an axis whose driver reports homing done
+   (MS_HOME_DONE) without an alarm gets position = lower = 0, persisted
+   in one NV write, and its direction blocks cleared; a search that ended
+   without finding the switch fails with HomeFailed. Total time is that
+   of the slowest axis.
+*/
+static bool     g_homing[MAX_AXES + 1];
+static uint32_t g_homeStartMs[MAX_AXES + 1];
+static uint8_t  g_homingCount  = 0;
+static uint8_t  g_homeOk       = 0;
+static uint8_t  g_homeFailed   = 0;
+static uint32_t g_homeBatchMs  = 0;
+
+static inline bool homingActive(uint8_t id) {
+  return axisValidId(id) && g_homing[id];
+}
+
+static inline void homingFinish(uint8_t id, bool ok, const String &why) {
+  g_homing[id] = false;
+  --g_homingCount;
+  if (ok) ++g_homeOk; else ++g_homeFailed;
+  printLineBoth("m" + String(id) + (ok ? ", homed, pos=0" : ", home failed: " + why));
+
+  if (g_homingCount == 0) {
+    printLineBoth("home done: " + String(g_homeOk) + " ok, " + String(g_homeFailed) +
+                  " failed, " + String(millis() - g_homeBatchMs) + " ms");
+  }
+}
+
+// Called when a stop is issued for an axis: the stop ends homing unsuccessfully
+static inline void homingAbort(uint8_t id) {
+  if (homingActive(id)) homingFinish(id, false, "stopped");
+}
+
+/* Start homing on ids[0..n); axes already homing are skipped. An axis
+   that is still moving (err=busy), or whose enable or homing-parameter
+   writes are not all acknowledged (err=NoAck), is refused and not
+   triggered. Returns number started. */
+static inline uint8_t homingStart(const uint8_t *ids, uint8_t n) {
+  if (g_homingCount == 0) {
+    g_homeOk = 0;
+    g_homeFailed = 0;
+    g_homeBatchMs = millis();
+  }
+
+  // 1) Parameters and enable for every selected axis
+  uint8_t sel[MAX_AXES];
+  uint8_t k = 0;
+  for (uint8_t i = 0; i < n && k < MAX_AXES; ++i) {
+    const uint8_t id = ids[i];
+    if (!axisPresent(id) || g_homing[id]) continue;
+    MotorState &m = mById(id);
+    if (m.moving) { printLineBoth("m" + String(id) + ", err=busy"); continue; }
+    if (!ensureMotorEnabled(id)) { printLineBoth("m" + String(id) + ", err=NoAck"); continue; }
+    // Homing registers are not shadowed: each write goes out and must be echoed
+    uint8_t f[MB_WRITE_MULTI_FRAME_MAX];
+    buildWriteFrame(id, REG_HOME_MODE, HOME_MODE_ORG_SWITCH, f);   // origin switch, negative direction
+    bool acked = tx(f);
+    const uint16_t home[2] = { 0, 0 };
+    acked = acked && tx(f, buildWriteMultipleFrame(id, REG_HOME_POS_HIGH, 2, home, f));
+    const uint16_t prof[4] = { HOME_SPEED_HIGH_RPM, HOME_SPEED_LOW_RPM, m.accel, m.decel };
+    acked = acked && tx(f, buildWriteMultipleFrame(id, REG_HOME_SPEED_HIGH, 4, prof, f));
+    if (!acked) { printLineBoth("m" + String(id) + ", err=NoAck"); continue; }   // never home on stale parameters
+    sel[k++] = id;
+  }
+
+  // 2) Triggers back-to-back: all selected axes home concurrently
+  uint8_t started = 0;
+  for (uint8_t i = 0; i < k; ++i) {
+    const uint8_t id = sel[i];
+    uint8_t f[8];
+    buildHomeFrame(id, f);
+    if (!tx(f)) continue;
+
+    MotorState &m = mById(id);
+    historyMoveBegin(id);
+    tagNoteStart(id);
+    m.lastMoveMs = millis();
+    m.moving = true;
+    m.settleMs = 0;             // no dwell left over from a path: check MS_HOME_DONE at the first stop
+    m.stopSent = false;
+    disableTimerCancel(id);
+    g_homing[id] = true;
+    g_homeStartMs[id] = m.lastMoveMs;
+    ++g_homingCount;
+    ++started;
+  }
+  return started;
+}
+
+static inline void serviceHoming() {
+  if (!g_homingCount) return;
+
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const uint8_t id = g_axes.ids[i];
+    if (!g_homing[id]) continue;
+    MotorState &m = mById(id);
+
+    if (m.moving) {
+      if (millis() - g_homeStartMs[id] >= HOME_TIMEOUT_MS) {
+        stopMotor(id);
+        homingFinish(id, false, "timeout");
+      }
+      continue;
+    }
+
+    // Stopped: success only if the driver found its reference and raised no alarm on the way
+    uint16_t alarm = alarmReadNow(id);
+    if (alarm != 0) {
+      homingFinish(id, false, alarm == 0xFFFF ? String("no reply") : "alarm 0x" + String(alarm, HEX));
+      continue;
+    }
+    const uint16_t ms = readReg(id, REG_MOTION_STATUS);
+    if (ms == 0xFFFF) { homingFinish(id, false, "no reply"); continue; }
+    if (!(ms & MS_HOME_DONE)) { homingFinish(id, false, "HomeFailed"); continue; }
+
+    m.position = 0;
+    m.lower    = 0;
+    m.hasLower = true;
+    m.lastDir  = 0;
+    m.blockNeg = false;         // the search ended on the switch; moving off it must be allowed
+    m.blockPos = false;
+    m.absOrigin = 0;            // driver assigned position 0 to the home point
+    m.absSynced = true;
+    nvSaveHomed(id);
+    homingFinish(id, true, "");
+  }
+}
+
+#endif // HOMING_H
@@ -3,19 +3,169 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "output.h"
+#include "trace.h"
 
-// Drive IO1 as constant logic 1 at boot; allow runtime on/off
+static inline void laserSet(bool on) {
+  digitalWrite(LASER_PIN, on ? HIGH : LOW);
+}
+
+static inline bool laserIsOn() {
+  return digitalRead(LASER_PIN) == HIGH;
+}
+
+/* ── Timed pulse ("laser pulse <us> [after m<id> ... done]") ─────────
+   The pulse width comes from TC7 (16-bit, one-shot, GCLK0 / 64: one
+   tick = 64 / F_CPU, 0.53 us at 120 MHz), not from the loop: the pin is
+   raised and the timer started back-to-back with interrupts off, and
+   the overflow interrupt drops the pin, so width and start are exact to
+   about a microsecond whatever loop() or a bus transaction is doing.
+   Pulses longer than one timer period (~35 ms) are chained in the ISR.
+
+   "after m<id> ... done" arms the pulse until every listed axis has
+   reported stopped (onAxisStopped), then fires it from there. Both edges
+   are timestamped with micros() — the flight-recorder clock (trace.h) —
+   into a small log ("laser pulses") and the trace, so exposures can be
+   matched with motion events. An axis that times out or is stopped
+   (quick-stop, estop) disarms the pulse instead.
+
+   The laser must be off to pulse. IO1 comes up at LASER_BOOT_ON (on by
+   default, as it always has), so "laser off" is needed once after boot
+   unless LASER_BOOT_ON is 0.
+*/
+static const uint32_t LASER_TC_HZ    = F_CPU / 64;
+static const uint32_t LASER_TC_CHUNK = 0x10000UL;      // ticks per timer period
+
+struct LaserPulse {
+  uint32_t widthUs;     // requested
+  uint32_t onUs;        // micros() at the rising edge
+  uint32_t offUs;       // micros() at the falling edge (0 while running)
+};
+
+static LaserPulse        g_laserLog[LASER_PULSE_LOG];
+static uint8_t           g_laserLogNext = 0;            // next slot to write
+static volatile bool     g_laserBusy    = false;        // pulse running
+static volatile bool     g_laserDone    = false;        // finished, not yet reported
+static volatile uint32_t g_laserTicksLeft = 0;          // ticks still to run after this period
+static LaserPulse       *volatile g_laserCur = nullptr;
+
+static uint64_t g_laserArmMask  = 0;                    // axes that must stop first
+static uint32_t g_laserArmWidth = 0;
+
+static inline void laserTcSync() {
+  while (TC7->COUNT16.SYNCBUSY.reg) {}
+}
+
+// Drive IO1 at its boot level (LASER_BOOT_ON); allow runtime on/off. Sets up the pulse timer.
 static inline void laserSetup() {
   pinMode(LASER_PIN, OUTPUT);
+  digitalWrite(LASER_PIN, LASER_BOOT_ON ? HIGH : LOW);
+
+  MCLK->APBDMASK.reg |= MCLK_APBDMASK_TC7;
+  GCLK->PCHCTRL[TC7_GCLK_ID].reg = GCLK_PCHCTRL_GEN_GCLK0 | GCLK_PCHCTRL_CHEN;
+  while (!(GCLK->PCHCTRL[TC7_GCLK_ID].reg & GCLK_PCHCTRL_CHEN)) {}
+
+  TC7->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+  laserTcSync();
+  TC7->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_PRESCALER_DIV64;
+  TC7->COUNT16.WAVE.reg  = TC_WAVE_WAVEGEN_MFRQ;         // TOP = CC0
+  TC7->COUNT16.CTRLBSET.reg = TC_CTRLBSET_ONESHOT;
+  laserTcSync();
+  TC7->COUNT16.INTENSET.reg = TC_INTENSET_OVF;
+  NVIC_SetPriority(TC7_IRQn, 0);
+  NVIC_EnableIRQ(TC7_IRQn);
+  TC7->COUNT16.CTRLA.reg |= TC_CTRLA_ENABLE;
+  laserTcSync();
+}
+
+// Start the next timer period of up to LASER_TC_CHUNK ticks
+static inline void laserTcRun(uint32_t ticks) {
+  const uint32_t n = ticks > LASER_TC_CHUNK ? LASER_TC_CHUNK : ticks;
+  g_laserTicksLeft = ticks - n;
+  TC7->COUNT16.CC[0].reg = (uint16_t)(n - 1);
+  laserTcSync();
+  TC7->COUNT16.CTRLBSET.reg = TC_CTRLBSET_CMD_RETRIGGER;
+}
+
+extern "C" void TC7_Handler() {
+  TC7->COUNT16.INTFLAG.reg = TC_INTFLAG_OVF;
+  if (g_laserTicksLeft) { laserTcRun(g_laserTicksLeft); return; }
+  digitalWrite(LASER_PIN, LOW);
+  const uint32_t t = micros();
+  if (g_laserCur) g_laserCur->offUs = t;
+  traceRecord(TR_LASER, 0, 0, t);
+  g_laserBusy = false;
+  g_laserDone = true;
+}
+
+// Returns nullptr once the pulse is running, or an error tag
+static inline const char *laserPulse(uint32_t widthUs) {
+  if (g_laserBusy) return "LaserBusy";
+  if (laserIsOn()) return "LaserOn";
+  if (widthUs == 0 || widthUs > LASER_PULSE_MAX_US) return "LaserPulseRange";
+
+  uint64_t ticks = ((uint64_t)widthUs * LASER_TC_HZ + 500000UL) / 1000000UL;
+  if (ticks < 2) ticks = 2;
+
+  LaserPulse &p = g_laserLog[g_laserLogNext];
+  g_laserLogNext = (uint8_t)((g_laserLogNext + 1) % LASER_PULSE_LOG);
+  p.widthUs = widthUs;
+  p.offUs   = 0;
+  g_laserCur  = &p;
+  g_laserBusy = true;
+
+  noInterrupts();
   digitalWrite(LASER_PIN, HIGH);
+  laserTcRun((uint32_t)ticks);
+  p.onUs = micros();
+  interrupts();
+
+  traceRecord(TR_LASER, 0, 1, widthUs);
+  return nullptr;
 }
 
-static inline void laserSet(bool on) {
-  digitalWrite(LASER_PIN, on ? HIGH : LOW);
+// Arm a pulse for when every axis in `mask` (bit id) has stopped
+static inline void laserArm(uint64_t mask, uint32_t widthUs) {
+  g_laserArmMask  = mask;
+  g_laserArmWidth = widthUs;
 }
 
-static inline bool laserIsOn() {
-  return digitalRead(LASER_PIN) == HIGH;
+static inline bool laserArmed() { return g_laserArmMask != 0; }
+static inline void laserDisarm() { g_laserArmMask = 0; }
+
+// Called from onAxisStopped(); completed = false (timeout, quick-stop, estop) disarms the pulse
+static inline void laserNoteStop(uint8_t id, bool completed) {
+  const uint64_t bit = (uint64_t)1 << id;
+  if (!(g_laserArmMask & bit)) return;
+  if (!completed) {
+    g_laserArmMask = 0;
+    printLineBoth("laser pulse disarmed: m" + String(id) + " did not complete its move");
+    return;
+  }
+  g_laserArmMask &= ~bit;
+  if (g_laserArmMask) return;
+  const char *err = laserPulse(g_laserArmWidth);
+  if (err) printLineBoth(String("laser pulse, err=") + err);
+}
+
+static inline String laserFmt(const LaserPulse &p) {
+  return "laser pulse width=" + String(p.widthUs) + "us, on=" + String(p.onUs) + ", off=" +
+         (p.offUs ? String(p.offUs) + " (" + String(p.offUs - p.onUs) + "us)" : String("running"));
+}
+
+// Main loop: report each finished pulse with its edge timestamps
+static inline void serviceLaser() {
+  if (!g_laserDone) return;
+  g_laserDone = false;
+  if (g_laserCur) printLineBoth(laserFmt(*g_laserCur));
+}
+
+// "laser pulses": logged pulses, oldest first
+static inline void laserPrintLog(void (*out)(const String &)) {
+  for (uint8_t k = 0; k < LASER_PULSE_LOG; ++k) {
+    const LaserPulse &p = g_laserLog[(g_laserLogNext + k) % LASER_PULSE_LOG];
+    if (p.widthUs) out(laserFmt(p));
+  }
 }
 
 #endif // LASER_H
@@ -0,0 +1,182 @@
+#ifndef MB_RX_H
+#define MB_RX_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "dm_556_rs_frames.h"
+#include "axis_table.h"
+
+/* ── RS-485 receive: framed rings ────────────────────────────────────
+   A periodic timer interrupt (TC6, every MB_RX_TICK_US) drains both bus
+   UARTs into one ring per port and stamps the time of the last byte.
+   Once a port has been silent for the Modbus 3.5-character interval the
+   bytes since the previous boundary are closed as one frame. The ISR is
+   the only producer and the main loop the only consumer, so the rings
+   need no locks: the ISR publishes a frame by advancing fHead after the
+   bytes are stored, the loop releases it by advancing fTail and tail.
+
+   mbRxPop() hands out one complete frame with its CRC already checked,
+   whatever its length, so a 5-byte exception, an 8-byte echo and an
+   n-register read reply all arrive the moment the line goes idle after
+   them. A late reply to an earlier request stays a frame of its own and
+   is recognised (and counted as stray) instead of shifting the next one.
+   Since a frame is only closed after the silent interval, the caller
+   may send its next request as soon as it has the reply.
+*/
+static_assert((MB_RX_RING_BYTES & (MB_RX_RING_BYTES - 1)) == 0, "MB_RX_RING_BYTES must be a power of two");
+static_assert((MB_RX_FRAMES & (MB_RX_FRAMES - 1)) == 0, "MB_RX_FRAMES must be a power of two");
+
+static const uint8_t MB_RX_FRAME_MAX = 64;   // longest reply we expect (a read of READ_REGS_MAX = 24 registers is 53)
+#if USE_COM0
+static const uint8_t MB_RX_PORTS = 2;        // [0] SerialPortA, [1] SerialPortB
+#else
+static const uint8_t MB_RX_PORTS = 1;
+#endif
+
+struct MbRxStats {
+  uint32_t frames;      // frames received (valid or not)
+  uint32_t crcErrors;   // bad CRC or too short
+  uint32_t overruns;    // ring full or frame longer than MB_RX_FRAME_MAX
+  uint32_t dropped;     // frame table full (written by the ISR)
+  uint32_t stray;       // valid frames nobody was waiting for
+};
+
+struct MbRxFrame {
+  uint8_t len;          // bytes stored in the ring
+  bool    bad;          // bytes were lost
+};
+
+struct MbRxRing {
+  uint8_t   buf[MB_RX_RING_BYTES];
+  MbRxFrame frames[MB_RX_FRAMES];
+  uint16_t  head;       // bytes stored          (ISR)
+  uint16_t  tail;       // bytes released        (loop)
+  uint8_t   fHead;      // frames published      (ISR)
+  uint8_t   fTail;      // frames released       (loop)
+  // ISR only: the frame being received
+  uint8_t   curLen;
+  bool      curBad;
+  bool      open;
+  uint32_t  lastUs;
+  MbRxStats stats;
+};
+
+static MbRxRing          g_mbRx[MB_RX_PORTS];
+static volatile uint32_t g_mbRxGapUs = 2005;   // 3.5 characters (set with the baud rate)
+
+static inline uint8_t mbRxPortMask(uint8_t k) { return k == 0 ? AXIS_PORT_A : AXIS_PORT_B; }
+
+/* ── Producer (TC6 interrupt) ─────────────────────────────────────── */
+static inline void mbRxClose(MbRxRing &q) {
+  const uint8_t fh = q.fHead;
+  if ((uint8_t)(fh - __atomic_load_n(&q.fTail, __ATOMIC_ACQUIRE)) >= MB_RX_FRAMES) {
+    q.head -= q.curLen;                       // unpublished: take the bytes back
+    ++q.stats.dropped;
+  } else {
+    q.frames[fh & (MB_RX_FRAMES - 1)] = MbRxFrame{ q.curLen, q.curBad };
+    __atomic_store_n(&q.fHead, (uint8_t)(fh + 1), __ATOMIC_RELEASE);
+  }
+  q.curLen = 0;
+  q.curBad = false;
+  q.open   = false;
+}
+
+static inline void mbRxDrain(MbRxRing &q, HardwareSerial &p, uint32_t now) {
+  bool any = false;
+  while (p.available() > 0) {
+    const int c = p.read();
+    if (c < 0) break;
+    any = true;
+    const uint16_t used = (uint16_t)(q.head - __atomic_load_n(&q.tail, __ATOMIC_ACQUIRE));
+    if (used >= MB_RX_RING_BYTES || q.curLen >= MB_RX_FRAME_MAX) { q.curBad = true; continue; }
+    q.buf[q.head & (MB_RX_RING_BYTES - 1)] = (uint8_t)c;
+    ++q.head;
+    ++q.curLen;
+  }
+  if (any) { q.lastUs = now; q.open = true; return; }
+  if (q.open && now - q.lastUs >= g_mbRxGapUs) mbRxClose(q);
+}
+
+extern "C" void TC6_Handler() {
+  TC6->COUNT16.INTFLAG.reg = TC_INTFLAG_OVF;
+  const uint32_t now = micros();
+  mbRxDrain(g_mbRx[0], SerialPortA, now);
+#if USE_COM0
+  mbRxDrain(g_mbRx[1], SerialPortB, now);
+#endif
+}
+
+static inline void mbRxSetup() {
+  MCLK->APBDMASK.reg |= MCLK_APBDMASK_TC6;
+  GCLK->PCHCTRL[TC6_GCLK_ID].reg = GCLK_PCHCTRL_GEN_GCLK0 | GCLK_PCHCTRL_CHEN;
+  while (!(GCLK->PCHCTRL[TC6_GCLK_ID].reg & GCLK_PCHCTRL_CHEN)) {}
+
+  TC6->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+  while (TC6->COUNT16.SYNCBUSY.reg) {}
+  TC6->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_PRESCALER_DIV8;
+  TC6->COUNT16.WAVE.reg  = TC_WAVE_WAVEGEN_MFRQ;          // period = CC0 + 1
+  TC6->COUNT16.CC[0].reg = (uint16_t)((F_CPU / 8 / 1000000UL) * MB_RX_TICK_US - 1);
+  while (TC6->COUNT16.SYNCBUSY.reg) {}
+  TC6->COUNT16.INTENSET.reg = TC_INTENSET_OVF;
+  NVIC_SetPriority(TC6_IRQn, 3);                          // below the laser timer
+  NVIC_EnableIRQ(TC6_IRQn);
+  TC6->COUNT16.CTRLA.reg |= TC_CTRLA_ENABLE;
+  while (TC6->COUNT16.SYNCBUSY.reg) {}
+}
+
+/* ── Consumer (main loop) ─────────────────────────────────────────── */
+// After a baud change: new silent interval, and nothing received at the old rate survives
+static inline void mbRxReset(uint32_t gapUs) {
+  noInterrupts();
+  g_mbRxGapUs = gapUs;
+  for (uint8_t k = 0; k < MB_RX_PORTS; ++k) {
+    MbRxRing &q = g_mbRx[k];
+    q.tail = q.head;
+    q.fTail = q.fHead;
+    q.curLen = 0;
+    q.curBad = false;
+    q.open   = false;
+  }
+  interrupts();
+}
+
+enum MbRxPop : uint8_t { MBRX_NONE = 0, MBRX_FRAME, MBRX_BAD };
+
+// Take the oldest complete frame of a port; MBRX_FRAME only if its CRC checks
+static inline MbRxPop mbRxPop(MbRxRing &q, uint8_t *out, uint8_t &len) {
+  if (q.fTail == __atomic_load_n(&q.fHead, __ATOMIC_ACQUIRE)) return MBRX_NONE;
+  const MbRxFrame f = q.frames[q.fTail & (MB_RX_FRAMES - 1)];
+  for (uint8_t i = 0; i < f.len; ++i) out[i] = q.buf[(uint16_t)(q.tail + i) & (MB_RX_RING_BYTES - 1)];
+  __atomic_store_n(&q.tail, (uint16_t)(q.tail + f.len), __ATOMIC_RELEASE);
+  __atomic_store_n(&q.fTail, (uint8_t)(q.fTail + 1), __ATOMIC_RELEASE);
+
+  ++q.stats.frames;
+  len = f.len;
+  if (f.bad) { ++q.stats.overruns; return MBRX_BAD; }
+  if (f.len < 4) { ++q.stats.crcErrors; return MBRX_BAD; }
+  const uint16_t c = modbusCRC(out, f.len - 2);
+  if (out[f.len - 2] != (c & 0xFF) || out[f.len - 1] != (c >> 8)) { ++q.stats.crcErrors; return MBRX_BAD; }
+  return MBRX_FRAME;
+}
+
+// Drop every complete frame still queued (before a new request); counted as stray
+static inline void mbRxDiscard() {
+  uint8_t f[MB_RX_FRAME_MAX];
+  uint8_t len;
+  for (uint8_t k = 0; k < MB_RX_PORTS; ++k) {
+    MbRxPop got;
+    while ((got = mbRxPop(g_mbRx[k], f, len)) != MBRX_NONE) {
+      if (got == MBRX_FRAME) ++g_mbRx[k].stats.stray;
+    }
+  }
+}
+
+static inline void mbRxClearStats() {
+  for (uint8_t k = 0; k < MB_RX_PORTS; ++k) {
+    noInterrupts();
+    memset(&g_mbRx[k].stats, 0, sizeof(MbRxStats));
+    interrupts();
+  }
+}
+
+#endif // MB_RX_H
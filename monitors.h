@@ -4,10 +4,12 @@
 #include <Arduino.h>
 #include "driver_io.h"
 #include "runtime_state.h"
+#include "laser.h"
+#include "tracking.h"
 
 // Optionally echo to Ethernet client like other prints
 extern EthernetClient client;
-extern bool pollEnabled[23];
+extern bool pollEnabled[MAX_AXES + 1];
 
 /* Helper: unified status line like "m1, pos=..., lo=..., hi=..., lim=..." */
 static inline String fmtStatusLine(uint8_t id) {
@@ -22,22 +24,23 @@ static inline String fmtStatusLine(uint8_t id) {
 
 void monitorMotionStates() {
   static uint32_t lastPoll = 0;
-  static uint8_t  nextId   = 1;
-  static uint16_t prev[23]  = {0xFFFF, 0xFFFF, 0xFFFF};
+  static uint8_t  next     = 0;     // index into g_axes.ids
+  static uint16_t prev[MAX_AXES + 1]  = {0xFFFF, 0xFFFF, 0xFFFF};
 
   if (millis() - lastPoll < 100) return;
   lastPoll = millis();
 
   // find next enabled ID to poll
   uint8_t id = 0;
-  for (uint8_t i = 0; i < 22; ++i) {
-    uint8_t cand = nextId;
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    if (next >= g_axes.count) next = 0;
+    uint8_t cand = g_axes.ids[next++];
     if (pollEnabled[cand]) { id = cand; break; }
-    nextId = (nextId == 22) ? 1 : (uint8_t)(nextId + 1);
   }
   if (!id) return;
 
   uint16_t ms = readReg(id, 0x1003);
+  if (ms != 0xFFFF) ms &= ~MS_HOME_DONE;    // set after homing; not a motion state
   if (ms != 0xFFFF && (ms == 0x0006 || ms == 0x0032) && ms != prev[id]) {
     // Build complete message as single string
     String msg = "m" + String(id) + " " + (ms == 0x0032 ? "stopped" : "moving");
@@ -53,10 +56,100 @@ void monitorMotionStates() {
   prev[id] = ms;
 
   delayMicroseconds(5000);
-  nextId = (id == 22) ? 1 : (uint8_t)(id + 1);
 }
 
 
+/* ── Move completion + auto-disable ───────────────────────────────────
+   Axes flagged `moving` are polled round-robin every MOTION_POLL_MS.
+   When one reports stopped, its auto-disable deadline is armed, so the
+   countdown runs from the end of the move rather than from the command
+   (long moves are no longer disabled mid-motion).
+
+   A move ends done, timed out (MOTION_MAX_MS without a stop), or
+   aborted (a quick-stop or the estop broadcast ended it); only a done
+   move counts towards an armed "laser pulse ... after".
+
+   serviceAutoDisable() looks only at the earliest deadline; when several
+   expire in the same tick they are handled together, and if they cover
+   every enabled axis a single broadcast disable replaces the unicasts.
+*/
+
+static inline void onAxisStopped(uint8_t id, AxisStop how) {
+  MotorState &m = mById(id);
+  m.moving = false;
+  historyMoveEnd(id, how);
+  tagNoteStop(id, how);
+  laserNoteStop(id, how == STOP_DONE);
+  // hold=standby axes stay enabled; the driver manages their idle current
+  if (m.enabled && m.holdMode == HOLD_DISABLE) disableTimerArm(id, millis() + DISABLE_TIMEOUT_MS);
+}
+
+static inline void monitorMoveCompletion() {
+  static uint32_t lastPoll = 0;
+  static uint8_t  next     = 0;     // index into g_axes.ids
+  static bool     stopSeen[MAX_AXES + 1];
+  static uint32_t stopSeenMs[MAX_AXES + 1];
+
+  if (millis() - lastPoll < MOTION_POLL_MS) return;
+  lastPoll = millis();
+
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    if (next >= g_axes.count) next = 0;
+    const uint8_t id = g_axes.ids[next++];
+
+    MotorState &m = mById(id);
+    if (!m.moving) continue;
+    if (trackActive(id)) {                    // ends only through trackStop()
+      stopSeen[id] = false;
+      continue;
+    }
+
+    const uint32_t age = millis() - m.lastMoveMs;
+    if (age < MOTION_START_MS) {              // driver may not have started yet
+      stopSeen[id] = false;
+      continue;
+    }
+
+    uint16_t ms = readReg(id, REG_MOTION_STATUS);
+    if (age >= MOTION_MAX_MS) {
+      stopSeen[id] = false;
+      onAxisStopped(id, STOP_TIMEOUT);
+    } else if (motionStopped(ms)) {
+      // A path with dwells looks stopped between segments: require the
+      // stop to outlast the longest dwell before calling the move done
+      if (!stopSeen[id]) { stopSeen[id] = true; stopSeenMs[id] = millis(); }
+      if (millis() - stopSeenMs[id] >= m.settleMs) {
+        stopSeen[id] = false;
+        onAxisStopped(id, m.stopSent ? STOP_ABORTED : STOP_DONE);
+      }
+    } else {
+      stopSeen[id] = false;
+    }
+    return;                                   // one bus read per tick
+  }
+}
+
+static inline void serviceAutoDisable() {
+  const uint32_t now = millis();
+  uint8_t due[MAX_AXES];
+  uint8_t n = 0;
+  for (uint8_t id; (id = disableTimerPopExpired(now)) != 0; ) {
+    if (mById(id).enabled) due[n++] = id;
+  }
+  if (!n) return;
+
+  uint8_t enabledCount = 0;
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    if (mById(g_axes.ids[i]).enabled) ++enabledCount;
+  }
+
+  if (n == enabledCount && n > 1) {
+    disableAllHW();
+  } else {
+    for (uint8_t i = 0; i < n; ++i) disableMotorHW(due[i]);
+  }
+}
+
 /* ── Limit-switch polling ONLY for M1 and M2 ───────────────────────
    DI2 (0x0147) = Positive limit (POT/PL)
    DI3 (0x0149) = Negative limit (NOT/NL)
@@ -66,17 +159,18 @@ void monitorMotionStates() {
 */
 static const uint8_t kLimitPollIds[] = { 1, 2 };
 static const uint8_t kLimitPollCount = sizeof(kLimitPollIds) / sizeof(kLimitPollIds[0]);
-static uint8_t  lsInited[23]       = {0};
-static uint8_t  lsIdleLevel_DI2[23] = {0};  // DI2 idle (positive limit)
-static uint8_t  lsIdleLevel_DI3[23] = {0};  // DI3 idle (negative limit)
-static uint8_t  lsPrevPressed_DI2[23] = {0};
-static uint8_t  lsPrevPressed_DI3[23] = {0};
-static uint32_t lsLastPollMs[23]  = {0};
+static uint8_t  lsInited[MAX_AXES + 1]       = {0};
+static uint8_t  lsIdleLevel_DI2[MAX_AXES + 1] = {0};  // DI2 idle (positive limit)
+static uint8_t  lsIdleLevel_DI3[MAX_AXES + 1] = {0};  // DI3 idle (negative limit)
+static uint8_t  lsPrevPressed_DI2[MAX_AXES + 1] = {0};
+static uint8_t  lsPrevPressed_DI3[MAX_AXES + 1] = {0};
+static uint32_t lsLastPollMs[MAX_AXES + 1]  = {0};
 
 static inline void monitorLimitSwitches_M12() {
   const uint32_t now = millis();
   for (uint8_t i = 0; i < kLimitPollCount; ++i) {
     const uint8_t id = kLimitPollIds[i];
+    if (!axisPresent(id)) continue;                 // not on this bus
 
     if (now - lsLastPollMs[id] < 10) continue;      // per-ID ≈10 ms
     lsLastPollMs[id] = now;
@@ -112,6 +206,8 @@ static inline void monitorLimitSwitches_M12() {
     }
 
     if (changed) {
+      historyNoteLimit(id);
+      traceRecord(TR_LIMIT, id, (uint16_t)((m.blockNeg ? 1 : 0) | (m.blockPos ? 2 : 0)));
       String s = fmtStatusLine(id);
       Serial.println(s);
       if (client && client.connected()) {
@@ -121,8 +217,6 @@ static inline void monitorLimitSwitches_M12() {
 
     lsPrevPressed_DI2[id] = pressed_di2;
     lsPrevPressed_DI3[id] = pressed_di3;
-
-    delayMicroseconds(5000);                        // modest RS-485 guard
   }
 }
 
@@ -1,28 +0,0 @@
-#ifndef MOTOR_IDS_H
-#define MOTOR_IDS_H
-#include <Arduino.h>
-
-constexpr uint8_t MOTOR1_ID  = 0x01;
-constexpr uint8_t MOTOR2_ID  = 0x02;
-constexpr uint8_t MOTOR3_ID  = 0x03;
-constexpr uint8_t MOTOR4_ID  = 0x04;
-constexpr uint8_t MOTOR5_ID  = 0x05;
-constexpr uint8_t MOTOR6_ID  = 0x06;
-constexpr uint8_t MOTOR7_ID  = 0x07;
-constexpr uint8_t MOTOR8_ID  = 0x08;
-constexpr uint8_t MOTOR9_ID  = 0x09;
-constexpr uint8_t MOTOR10_ID = 0x0A;
-constexpr uint8_t MOTOR11_ID = 0x0B;
-constexpr uint8_t MOTOR12_ID = 0x0C;
-constexpr uint8_t MOTOR13_ID = 0x0D;
-constexpr uint8_t MOTOR14_ID = 0x0E;
-constexpr uint8_t MOTOR15_ID = 0x0F;
-constexpr uint8_t MOTOR16_ID = 0x10;
-constexpr uint8_t MOTOR17_ID = 0x11;
-constexpr uint8_t MOTOR18_ID = 0x12;
-constexpr uint8_t MOTOR19_ID = 0x13;
-constexpr uint8_t MOTOR20_ID = 0x14;
-constexpr uint8_t MOTOR21_ID = 0x15;
-constexpr uint8_t MOTOR22_ID = 0x16;
-
-#endif
@@ -2,31 +2,126 @@
 #define MOTOR_INIT_H
 
 #include "driver_io.h"
-#include "motor_ids.h"
+#include "axis_table.h"
+#include "nv_store.h"
+
+/* ── Bus scan ─────────────────────────────────────────────────────────
+   Probes every id 1..MAX_AXES once on both buses with a one-register
+   read and a short timeout (BUS_SCAN_TIMEOUT_MS), and records which ids
+   answered and on which port. The table replaces the fixed list of 22
+   drivers: boot, polling and "all" commands visit only these axes, and
+   frames to an axis go out only on its own port. The table is saved in
+   the NV globals; boot scans only if none was saved.
+*/
+static inline uint8_t busScan() {
+  uint8_t port[MAX_AXES + 1] = { 0 };
+  for (uint8_t id = 1; id <= MAX_AXES; ++id) {
+    uint8_t req[8], r[7];
+    buildReadFrame(id, REG_RS485_BAUD, 1, req);
+    flushBoth();
+    txPort(SerialPortA, req, 8);
+#if USE_COM0
+    txPort(SerialPortB, req, 8);
+#endif
+    uint8_t p = AXIS_PORT_NONE;
+    if (mbReceive(id, FC_READ_HOLDING, r, 7, BUS_SCAN_TIMEOUT_MS * 1000UL, &p) == MB_OK) {
+      port[id] = p;
+      healthNoteReply(id, -1);
+    }
+  }
+  if (g_estopPending) return g_axes.count;   // interrupted: keep the previous table
+  axisTableSet(port);
+  return g_axes.count;
+}
+
+// "3 axes: m1(A) m2(A) m7(B)"
+static inline String axisTableSummary() {
+  String s = String(g_axes.count) + " axes:";
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const uint8_t id = g_axes.ids[i];
+    const uint8_t p = g_axes.port[id];
+    s += " m" + String(id) + (p == AXIS_PORT_A ? "(A)" : (p == AXIS_PORT_B ? "(B)" : "(A+B)"));
+  }
+  return s;
+}
+
+/* ── Boot-time read-compare of driver configuration ──────────────────
+   Instead of blindly writing the six configuration registers to every
+   driver, read them back and write only the ones that differ:
+     0x0001         microstep          (1 read)
+     0x0191         peak current       (1 read)
+     0x6200..0x6205 PR0 mode/pos/vel/accel/decel (1 batched read)
+
+   syncDriver() handles one axis at a time: the three reads (a fourth
+   for hold=standby axes) seed the register shadow (driver_shadow.h),
+   then initDriver() compares against the shadow and sends only the
+   mismatching registers. Each read is one round trip; they are not
+   overlapped across axes or buses. A reboot that changes nothing
+   therefore costs three short reads per axis and no writes, and each
+   axis becomes usable as soon as its own sync is done.
+
+   An axis whose driver does not answer the read-back (still powering
+   up, cable loose) is not skipped for the session: it stays in
+   g_cfgPending and serviceDriverSync() retries it every DRIVER_RETRY_MS
+   from the loop, configuring it with the same read-compare as soon as
+   it answers. Boot (boot.h) and "bus scan" both go through syncDriver().
+*/
+static uint64_t g_cfgPending = 0;     // bit id: configuration read not answered yet
+static inline bool readDriverCfg(uint8_t id) {
+  uint16_t v[6];
+  bool ok = readRegs(id, REG_MICROSTEP, 1, v) &&
+            readRegs(id, REG_PEAK_CURRENT, 1, v) &&
+            readRegs(id, REG_PR0_MODE, 6, v);
+  // Standby delay/current (0x01D1..0x01D3) only for axes that use them
+  if (ok && mById(id).holdMode == HOLD_STANDBY) ok = readRegs(id, REG_STANDBY_DELAY_MS, 3, v);
+  return ok;
+}
+
+// Read-compare-write one driver: frames written, or -1 if it did not answer (left pending)
+static inline int syncDriver(uint8_t id) {
+  const uint64_t bit = (uint64_t)1 << id;
+  if (!readDriverCfg(id)) { g_cfgPending |= bit; return -1; }
+  g_cfgPending &= ~bit;
+  return initDriver(id);
+}
+
+// Loop: retry one pending axis per DRIVER_RETRY_MS
+static inline void serviceDriverSync() {
+  static uint32_t lastMs = 0;
+  static uint8_t  next   = 0;     // index into g_axes.ids
+  if (!g_cfgPending || millis() - lastMs < DRIVER_RETRY_MS) return;
+  lastMs = millis();
+
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    if (next >= g_axes.count) next = 0;
+    const uint8_t id = g_axes.ids[next++];
+    if (!(g_cfgPending & ((uint64_t)1 << id))) continue;
+    const int n = syncDriver(id);
+    if (n >= 0) printLineBoth("m" + String(id) + ", driver answered, configured (" + String(n) + " frames)");
+    return;
+  }
+  g_cfgPending = 0;               // pending ids no longer in the axis table
+}
 
 static inline void initAllDrivers() {
-  initDriver(MOTOR1_ID);
-  initDriver(MOTOR2_ID);
-  initDriver(MOTOR3_ID);
-  initDriver(MOTOR4_ID);
-  initDriver(MOTOR5_ID);
-  initDriver(MOTOR6_ID);
-  initDriver(MOTOR7_ID);
-  initDriver(MOTOR8_ID);
-  initDriver(MOTOR9_ID);
-  initDriver(MOTOR10_ID);
-  initDriver(MOTOR11_ID);
-  initDriver(MOTOR12_ID);
-  initDriver(MOTOR13_ID);
-  initDriver(MOTOR14_ID);
-  initDriver(MOTOR15_ID);
-  initDriver(MOTOR16_ID);
-  initDriver(MOTOR17_ID);
-  initDriver(MOTOR18_ID);
-  initDriver(MOTOR19_ID);
-  initDriver(MOTOR20_ID);
-  initDriver(MOTOR21_ID);
-  initDriver(MOTOR22_ID);
+  const uint32_t t0 = millis();
+  uint8_t  missing = 0;
+  uint8_t  updated = 0;
+  uint16_t frames  = 0;
+
+  g_cfgPending = 0;               // a new table: only its axes can be pending
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const int n = syncDriver(g_axes.ids[i]);
+    if (n < 0) ++missing;
+    else if (n) { frames += n; ++updated; }
+  }
+
+  Serial.print("Drivers: ");
+  Serial.print(g_axes.count - missing - updated); Serial.print(" in sync, ");
+  Serial.print(updated);  Serial.print(" updated (");
+  Serial.print(frames);   Serial.print(" frames), ");
+  Serial.print(missing);  Serial.print(" no reply (retrying), ");
+  Serial.print(millis() - t0); Serial.println(" ms");
 }
 
 #endif // MOTOR_INIT_H
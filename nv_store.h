@@ -6,11 +6,16 @@
 #include <SD.h>
 #include "config.h"
 #include "runtime_state.h"
+#include "axis_table.h"
 
 /* Layout:
    [Header] { magic(4)="AOB1", version(2)=1, pad(2)=0 }  -> 8 bytes
-   22 * Entry { position(int32), lower(int32), upper(int32), flags(uint8), pad[3] } -> 16 bytes each
-   Total used bytes: 8 + 22*16 = 360; file size rounded to NV_IMAGE_BYTES
+   MAX_AXES * Entry { position(int32), lower(int32), upper(int32), flags(uint8), standbyPct(uint8),
+                velocity, accel, decel, peakCurr, microstep (uint16 each) } -> 24 bytes each
+   Total used bytes: 8 + MAX_AXES*24 (536 for 22); file size rounded to NV_IMAGE_BYTES
+   standbyPct occupies what used to be alignment padding; 0 there means "default".
+   [Globals] at NV_GLOBALS_OFFSET (1024): controller-wide settings, 0 = default
+             (bus baud, axis table from the last bus scan).
 */
 
 struct NvHeader {
@@ -23,7 +28,8 @@ struct NvEntry {
   int32_t position;
   int32_t lower;
   int32_t upper;
-  uint8_t flags;      // bit0: hasLower, bit1: hasUpper
+  uint8_t flags;      // bit0: hasLower, bit1: hasUpper, bit2: hold=standby
+  uint8_t standbyPct; // standby current % of peak (0 = STANDBY_CUR_PERCENT)
   uint16_t velocity;  // RPM
   uint16_t accel;     // ms per 1000 RPM
   uint16_t decel;     // ms per 1000 RPM
@@ -31,11 +37,25 @@ struct NvEntry {
   uint16_t microstep; // microstep code
 };
 
+static const uint8_t NV_AXIS_SLOTS = 64;     // axis-table capacity in the image (ids 0..63)
+
+struct NvGlobals {
+  uint32_t busBaud;                    // RS-485 rate the drivers were migrated to (0 = MODBUS_BAUD)
+  uint8_t  axisTableValid;             // 1 once a bus scan has been saved
+  uint8_t  axisPort[NV_AXIS_SLOTS];    // per id: AXIS_PORT_* (0 = absent)
+  uint32_t busBaudPrev;                // rate before a migration not yet confirmed at boot (0 = none)
+};
+
+static const int      NV_GLOBALS_OFFSET = 1024;
+
+static_assert(MAX_AXES < NV_AXIS_SLOTS, "axis table does not fit the NV globals");
+static_assert(8 + MAX_AXES * 24 <= NV_GLOBALS_OFFSET, "per-axis entries overlap the NV globals");
+static_assert(NV_GLOBALS_OFFSET + sizeof(NvGlobals) <= NV_IMAGE_BYTES, "NV globals exceed the image");
 static const uint32_t NV_MAGIC   = 0x414F4231UL; // "AOB1"
 static const uint16_t NV_VERSION = 1;
 
 static inline int entryOffset(uint8_t id) {
-  // id 1..22
+  // id 1..MAX_AXES
   return (int)sizeof(NvHeader) + (int)(id - 1) * (int)sizeof(NvEntry);
 }
 
@@ -126,7 +146,7 @@ static inline void nvLoadAllFromDisk() {
   memcpy(&hdr, buf, sizeof(hdr));
   if (hdr.magic != NV_MAGIC || hdr.version != NV_VERSION) return;
 
-  for (uint8_t id = 1; id <= 22; ++id) {
+  for (uint8_t id = 1; id <= MAX_AXES; ++id) {
     NvEntry e{};
     int off = entryOffset(id);
     memcpy(&e, buf + off, sizeof(e));
@@ -142,12 +162,14 @@ static inline void nvLoadAllFromDisk() {
     m.decel = e.decel ? e.decel : DECEL;
     m.peakCurr = e.peakCurr ? e.peakCurr : PEAK_CURRENT;
     m.microstep = e.microstep ? e.microstep : MICROSTEP;
+    m.holdMode = (e.flags & 0x04) ? HOLD_STANDBY : HOLD_DISABLE;
+    m.standbyPct = e.standbyPct ? e.standbyPct : STANDBY_CUR_PERCENT;
   }
 }
 
 /* --- Entry load/store without <functional> or lambdas --- */
 static inline bool nvLoadEntry(uint8_t id, NvEntry &out) {
-  if (!nv_sd_ready() || id < 1 || id > 22) return false;
+  if (!nv_sd_ready() || id < 1 || id > MAX_AXES) return false;
 
   uint8_t *buf = nv_buf();
   if (!nv_read_all(buf, NV_IMAGE_BYTES)) return false;
@@ -162,7 +184,7 @@ static inline bool nvLoadEntry(uint8_t id, NvEntry &out) {
 }
 
 static inline bool nvStoreEntry(uint8_t id, const NvEntry &in) {
-  if (!nv_sd_ready() || id < 1 || id > 22) return false;
+  if (!nv_sd_ready() || id < 1 || id > MAX_AXES) return false;
 
   uint8_t *buf = nv_buf();
   if (!nv_read_all(buf, NV_IMAGE_BYTES)) return false;
@@ -177,6 +199,34 @@ static inline bool nvStoreEntry(uint8_t id, const NvEntry &in) {
   return nv_write_all(buf, NV_IMAGE_BYTES);
 }
 
+static inline bool nvLoadGlobals(NvGlobals &out) {
+  if (!nv_sd_ready()) return false;
+
+  uint8_t *buf = nv_buf();
+  if (!nv_read_all(buf, NV_IMAGE_BYTES)) return false;
+
+  NvHeader hdr{};
+  memcpy(&hdr, buf, sizeof(hdr));
+  if (hdr.magic != NV_MAGIC || hdr.version != NV_VERSION) return false;
+
+  memcpy(&out, buf + NV_GLOBALS_OFFSET, sizeof(out));
+  return true;
+}
+
+static inline bool nvStoreGlobals(const NvGlobals &in) {
+  if (!nv_sd_ready()) return false;
+
+  uint8_t *buf = nv_buf();
+  if (!nv_read_all(buf, NV_IMAGE_BYTES)) return false;
+
+  NvHeader hdr{};
+  memcpy(&hdr, buf, sizeof(hdr));
+  if (hdr.magic != NV_MAGIC || hdr.version != NV_VERSION) return false;
+
+  memcpy(buf + NV_GLOBALS_OFFSET, &in, sizeof(in));
+  return nv_write_all(buf, NV_IMAGE_BYTES);
+}
+
 /* --- Convenience save helpers used by the rest of the code --- */
 static inline void nvSavePosition(uint8_t id, int32_t pos) {
   NvEntry e{};
@@ -201,6 +251,16 @@ static inline void nvSaveUpper(uint8_t id, int32_t upper, bool set = true) {
   nvStoreEntry(id, e);
 }
 
+// After homing: position = lower = 0, lower marked set (one file write)
+static inline void nvSaveHomed(uint8_t id) {
+  NvEntry e{};
+  if (!nvLoadEntry(id, e)) return;
+  e.position = 0;
+  e.lower = 0;
+  e.flags = (uint8_t)(e.flags | 0x01);
+  nvStoreEntry(id, e);
+}
+
 static inline void nvSaveMotorParams(uint8_t id, uint16_t vel, uint16_t acc, uint16_t dec, uint16_t peak, uint16_t micro) {
   NvEntry e{};
   if (!nvLoadEntry(id, e)) return;
@@ -212,4 +272,49 @@ static inline void nvSaveMotorParams(uint8_t id, uint16_t vel, uint16_t acc, uin
   nvStoreEntry(id, e);
 }
 
+static inline void nvSaveHold(uint8_t id, uint8_t holdMode, uint8_t standbyPct) {
+  NvEntry e{};
+  if (!nvLoadEntry(id, e)) return;
+  if (holdMode == HOLD_STANDBY) e.flags = (uint8_t)(e.flags | 0x04);
+  else                          e.flags = (uint8_t)(e.flags & ~0x04);
+  e.standbyPct = standbyPct;
+  nvStoreEntry(id, e);
+}
+
+static inline uint32_t nvLoadBusBaud() {
+  NvGlobals g{};
+  return (nvLoadGlobals(g) && g.busBaud) ? g.busBaud : MODBUS_BAUD;
+}
+
+static inline uint32_t nvLoadBusBaudPrev() {
+  NvGlobals g{};
+  return nvLoadGlobals(g) ? g.busBaudPrev : 0;
+}
+
+// prev = the rate the drivers answer at until they are power-cycled (0 once confirmed)
+static inline void nvSaveBusBaud(uint32_t baud, uint32_t prev) {
+  NvGlobals g{};
+  if (!nvLoadGlobals(g)) return;
+  g.busBaud     = baud;
+  g.busBaudPrev = prev;
+  nvStoreGlobals(g);
+}
+
+// Axis table from the last bus scan; false (table left empty) if none was saved
+static inline bool nvLoadAxisTable() {
+  NvGlobals g{};
+  if (!nvLoadGlobals(g) || g.axisTableValid != 1) return false;
+  axisTableSet(g.axisPort);
+  return true;
+}
+
+static inline void nvSaveAxisTable() {
+  NvGlobals g{};
+  if (!nvLoadGlobals(g)) return;
+  memset(g.axisPort, 0, sizeof(g.axisPort));
+  for (uint8_t id = 1; id <= MAX_AXES; ++id) g.axisPort[id] = g_axes.port[id];
+  g.axisTableValid = 1;
+  nvStoreGlobals(g);
+}
+
 #endif // NV_STORE_H
@@ -0,0 +1,37 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <Arduino.h>
+#include "config.h"
+
+extern EthernetClient client;
+
+/* ── Console output ──────────────────────────────────────────────────
+   Every line meant for the operator — command replies as well as the
+   reports modules print on their own (homing, alarms, estop, scripts,
+   ...) — goes out through printLineBoth(): the serial console and, when
+   connected, the TCP client.
+
+   While a tagged command runs (tags.h) each line carries its "#<tag> "
+   prefix, and an error line ("err=" / "ERROR") marks that command
+   rejected, whichever module printed it.
+*/
+static char g_tagCur[TAG_LEN + 1] = "";   // tag of the command being executed
+static bool g_tagRejected = false;        // it printed an error
+
+static inline String tagPrefix() {
+  return g_tagCur[0] ? "#" + String(g_tagCur) + " " : String("");
+}
+
+// Both outputs, as is: tag status lines (tags.h) carry their own tag
+static inline void printLineRaw(const String &s) {
+  Serial.println(s);
+  if (client && client.connected()) client.println(s);
+}
+
+static inline void printLineBoth(const String &s) {
+  if (g_tagCur[0] && (s.indexOf("err=") >= 0 || s.startsWith("ERROR"))) g_tagRejected = true;
+  printLineRaw(tagPrefix() + s);
+}
+
+#endif // OUTPUT_H
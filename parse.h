@@ -6,15 +6,29 @@
 #include <string.h>
 #include <stdlib.h>
 #include "config.h"
+#include "output.h"
 #include "driver_io.h"
 #include "nv_store.h"
 #include "runtime_state.h"
 #include "laser.h"
+#include "homing.h"
+#include "pr_paths.h"
+#include "tracking.h"
+#include "coord_move.h"
+#include "motor_init.h"
+#include "bus_baud.h"
+#include "telemetry.h"
+#include "boot.h"
+#include "alarm_scan.h"
+#include "tags.h"
+#include "estop.h"
+#include "coalesce.h"
+#include "drv_backup.h"
 
 // Provided by main.ino
 extern EthernetClient client;
 extern uint8_t  fanSetpoint;
-extern bool     pollEnabled[23];
+extern bool     pollEnabled[MAX_AXES + 1];
 extern bool     g_adminMode;
 extern bool     g_engineeringMode;
 
@@ -33,9 +47,11 @@ static inline bool ieqStr(const char *a, const char *b) {
   return *a == '\0' && *b == '\0';
 }
 
-static inline void printLineBoth(const String &s) {
-  Serial.println(s);
-  client.println(s);
+// Bus-wide commands wait until boot has configured every driver (boot.h)
+static inline bool refuseWhileBooting() {
+  if (bootDriversReady()) return false;
+  printLineBoth("err=Booting");
+  return true;
 }
 
 // Unified status formatter
@@ -50,17 +66,250 @@ static inline String fmtStatus(uint8_t id) {
          ", lo=" + lo + ", hi=" + hi + ", lim=" + lim;
 }
 
+// ─── Moves (parser and scripts) ─────────────────────────────────────
+// Each prints its reply and returns false only if it printed an error.
+
+// Relative move "m<id>, <steps>": soft limits and direction blocks unless admin mode
+static inline bool cmdMoveRel(uint8_t id, long steps) {
+  if (steps == 0) {
+    printLineBoth(fmtStatus(id));
+    return true;
+  }
+
+  MotorState &m = mById(id);
+  if (trackActive(id)) { printLineBoth("m" + String(id) + ", err=Tracking"); return false; }
+
+  // With a coalescing window the move is relative to the pending target
+  const bool    queue = coalesceEnabled(id);
+  const int32_t base  = queue ? coalesceBase(id) : m.position;
+
+  if (!g_adminMode) {
+    if (steps < 0 && m.blockNeg) { printLineBoth(fmtStatus(id)); return true; }
+    if (steps > 0 && m.blockPos) { printLineBoth(fmtStatus(id)); return true; }
+
+    int32_t desired = base + steps;
+    if (steps < 0 && m.hasLower && desired < m.lower) {
+      steps = m.lower - base;         // clamp ≤ 0
+    }
+    if (steps > 0 && m.hasUpper && desired > m.upper) {
+      steps = m.upper - base;         // clamp ≥ 0
+    }
+    if (steps == 0) {
+      printLineBoth(queue && coalescePending(id) ? coalesceStatus(id) : fmtStatus(id));
+      return true;
+    }
+  }
+
+  if (queue) {
+    coalesceQueue(id, base + (int32_t)steps, false);
+    printLineBoth(coalesceStatus(id));
+    return true;
+  }
+
+  if (!moveMotor(id, steps)) { printLineBoth("m" + String(id) + ", err=NoAck"); return false; }
+  printLineBoth(fmtStatus(id));
+  return true;
+}
+
+// Absolute move "m<id>, MoveTo <target>"
+static inline bool cmdMoveAbs(uint8_t id, long target) {
+  MotorState &m = mById(id);
+  if (trackActive(id)) { printLineBoth("m" + String(id) + ", err=Tracking"); return false; }
+
+  // Apply soft limits in absolute space if not in admin mode
+  if (!g_adminMode) {
+    if (m.hasLower && target < m.lower) target = m.lower;
+    if (m.hasUpper && target > m.upper) target = m.upper;
+  }
+
+  const bool queue = coalesceEnabled(id);
+  long steps = target - (queue ? coalesceBase(id) : m.position);
+
+  if (!g_adminMode) {
+    // Respect direction blocks
+    if (steps < 0 && m.blockNeg) { printLineBoth(fmtStatus(id)); return true; }
+    if (steps > 0 && m.blockPos) { printLineBoth(fmtStatus(id)); return true; }
+  }
+
+  if (steps == 0) {
+    // Already at (clamped) target
+    printLineBoth(queue && coalescePending(id) ? coalesceStatus(id) : fmtStatus(id));
+    return true;
+  }
+
+  if (queue) {
+    coalesceQueue(id, (int32_t)target, true);
+    printLineBoth(coalesceStatus(id));
+    return true;
+  }
+
+  // Report what we are about to do
+  String info = "m" + String(id) +
+                ", moveto target=" + String(target) +
+                ", steps=" + String(steps);
+  printLineBoth(info);
+
+  const char *err = moveMotorAbs(id, target);
+  if (err) {
+    printLineBoth("m" + String(id) + ", err=" + err);
+    return false;
+  }
+  printLineBoth(fmtStatus(id));
+  return true;
+}
+
+/* Coordinated batch ("sync ..."): soft limits and direction blocks apply
+   as for single moves; axes that end up with nothing to do are dropped,
+   the rest arrive together. An axis listed twice rejects the whole batch
+   before anything moves. */
+static inline bool cmdSync(const MoveSpec *mv, uint8_t nm) {
+  uint64_t seen = 0;
+  for (uint8_t k = 0; k < nm; ++k) {
+    const uint8_t id = mv[k].id;
+    if (!axisValidId(id)) continue;
+    if (seen & ((uint64_t)1 << id)) { printLineBoth("m" + String(id) + ", err=DuplicateAxis"); return false; }
+    seen |= (uint64_t)1 << id;
+  }
+
+  CoordAxis ax[MAX_AXES];
+  uint8_t n = 0;
+  bool ok = true;
+
+  for (uint8_t k = 0; k < nm; ++k) {
+    const uint8_t id = mv[k].id;
+    if (!axisPresent(id) || n >= MAX_AXES) continue;
+    if (trackActive(id) || homingActive(id)) { printLineBoth("m" + String(id) + ", err=busy"); ok = false; continue; }
+    coalesceFlush(id);
+    MotorState &m = mById(id);
+
+    long target = mv[k].absolute ? mv[k].value : m.position + mv[k].value;
+    if (!g_adminMode) {
+      if (m.hasLower && target < m.lower) target = m.lower;
+      if (m.hasUpper && target > m.upper) target = m.upper;
+      if (target < m.position && m.blockNeg) target = m.position;
+      if (target > m.position && m.blockPos) target = m.position;
+    }
+    if (target == m.position) continue;
+
+    ax[n].id       = id;
+    ax[n].absolute = mv[k].absolute;
+    ax[n].steps    = (int32_t)(target - m.position);
+    ++n;
+  }
+
+  if (!n) { printLineBoth("sync: nothing to move"); return ok; }
+  const uint32_t ms = coordPlan(ax, n);
+  const uint8_t started = coordExecute(ax, n);
+  printLineBoth("sync: " + String(started) + "/" + String(n) + " axes, " + String(ms) + " ms");
+  for (uint8_t i = 0; i < n; ++i) printLineBoth(fmtStatus(ax[i].id));
+  return ok && started == n;
+}
+
+// ─── Driver parameter snapshots ─────────────────────────────────────
+// "drv backup m<id>|all" | "drv verify m<id>|all" | "drv restore m<id>|all [from m<src>] [save]" (admin)
+static inline void parseDrv(char *args) {
+  if (refuseWhileBooting()) return;
+  char *op  = strtok(args, " ,\t");
+  char *who = strtok(nullptr, " ,\t");
+  const bool backup  = ieqStr(op, "backup");
+  const bool verify  = ieqStr(op, "verify");
+  const bool restore = ieqStr(op, "restore");
+  if (!(backup || verify || restore) || !who) { printLineBoth("drv, err=Syntax"); return; }
+
+  uint8_t src  = 0;
+  bool    save = false;
+  for (char *t = strtok(nullptr, " ,\t"); t; t = strtok(nullptr, " ,\t")) {
+    if (restore && ieqStr(t, "save")) { save = true; continue; }
+    char *s = restore && ieqStr(t, "from") ? strtok(nullptr, " ,\t") : nullptr;
+    src = (s && (s[0] == 'M' || s[0] == 'm')) ? (uint8_t)atoi(s + 1) : 0;
+    if (!axisValidId(src)) { printLineBoth("drv, err=Syntax"); return; }
+  }
+
+  const bool all = ieqStr(who, "all");
+  const uint8_t one = (who[0] == 'M' || who[0] == 'm') ? (uint8_t)atoi(who + 1) : 0;
+  if (!all && !axisPresent(one)) { printLineBoth("drv, err=NoAxis"); return; }
+  if (all && src) { printLineBoth("drv, err=Syntax"); return; }
+  if (restore && !g_adminMode) {
+    printLineBoth("ERROR: Admin mode required to restore driver parameters. Use 'admin on' first.");
+    return;
+  }
+
+  const uint32_t t0 = millis();
+  uint8_t n = 0, ok = 0;
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const uint8_t id = g_axes.ids[i];
+    if (!all && id != one) continue;
+    ++n;
+    const uint32_t t1 = millis();
+    uint16_t reg = 0xFFFF;
+    uint8_t  frames = 0;
+    const char *err;
+    if (backup)                err = drvBackup(id);
+    else if (verify)           err = drvVerify(id, reg);
+    else if (mById(id).moving) err = "busy";
+    else                       err = drvRestore(id, src ? src : id, save, reg, frames);
+
+    if (err) {
+      printLineBoth("m" + String(id) + ", drv " + op + ", err=" + err +
+                    (reg != 0xFFFF ? " at 0x" + String(reg, HEX) : String("")));
+      continue;
+    }
+    ++ok;
+    printLineBoth("m" + String(id) + ", drv " + op + " ok, " + String(g_drvSnap.hdr.regs) + " regs" +
+                  (restore ? ", " + String(frames) + " frames" + (save ? ", saved" : "") : String("")) +
+                  ", " + String(millis() - t1) + " ms");
+  }
+  if (all) printLineBoth("drv " + String(op) + ": " + String(ok) + "/" + String(n) + " axes, " + String(millis() - t0) + " ms");
+}
+
 // ─── Single token parser ────────────────────────────────────────────
-static inline void parseSingle(char *cmd) {
+static inline void parseCommand(char *cmd) {
   if (!cmd || !*cmd) return;
+  {
+    const size_t len = strlen(cmd);
+    uint32_t head = 0;
+    for (uint8_t k = 0; k < 4; ++k) head = (head << 8) | (uint8_t)(k < len ? cmd[k] : ' ');
+    traceRecord(TR_CMD, 0, (uint16_t)len, head);
+  }
 
-  // Global: stop all
-  if (ieqStr(cmd, "stop all")) {
-    for (uint8_t id = 1; id <= 22; ++id) stopMotor(id);
+  // Global: stop all / emergency stop — one broadcast quick-stop on both buses (estop.h)
+  if (ieqStr(cmd, "stop all") || ieqStr(cmd, "estop")) {
+    estopTrigger(ieqStr(cmd, "estop") ? "estop" : "stop all");
+    estopExecute();
     printLineBoth("all, stop");
     return;
   }
 
+  // Global: driver-native homing "home m1 m2 ..." | "home all" (admin mode)
+  if (strncasecmp(cmd, "home", 4) == 0 && (cmd[4] == ' ' || cmd[4] == '\0')) {
+    if (refuseWhileBooting()) return;
+    if (!g_adminMode) {
+      printLineBoth("ERROR: Admin mode required for homing. Use 'admin on' first.");
+      return;
+    }
+    uint8_t ids[MAX_AXES];
+    uint8_t n = 0;
+    for (char *t = strtok(cmd + 4, " ,\t"); t; t = strtok(nullptr, " ,\t")) {
+      if (ieqStr(t, "all")) {
+        n = 0;
+        for (uint8_t i = 0; i < g_axes.count; ++i) if (!trackActive(g_axes.ids[i])) ids[n++] = g_axes.ids[i];
+        break;
+      }
+      if ((t[0] == 'M' || t[0] == 'm') && n < MAX_AXES) {
+        uint8_t id = (uint8_t)atoi(t + 1);
+        if (axisPresent(id) && !trackActive(id)) ids[n++] = id;
+      }
+    }
+    if (!n) { printLineBoth("err=HomeMissingAxes"); return; }
+    for (uint8_t i = 0; i < n; ++i) coalesceFlush(ids[i]);
+    uint8_t started = homingStart(ids, n);
+    printLineBoth("home started: " + String(started) + " axes");
+    return;
+  }
+
+  // Global: startup timing "boot"
+  if (ieqStr(cmd, "boot")) { printLineBoth(bootSummary()); return; }
+
   // Global: admin
   if (ieqStr(cmd, "admin on"))  { g_adminMode = true;  printLineBoth("admin=on");  return; }
   if (ieqStr(cmd, "admin off")) { g_adminMode = false; printLineBoth("admin=off"); return; }
@@ -74,7 +323,8 @@ static inline void parseSingle(char *cmd) {
   // Global: read all motor parameters from SD card
   if (ieqStr(cmd, "read all")) {
     printLineBoth("=== MOTOR PARAMETERS ===");
-    for (uint8_t id = 1; id <= 22; ++id) {
+    for (uint8_t i = 0; i < g_axes.count; ++i) {
+      const uint8_t id = g_axes.ids[i];
       MotorState &m = mById(id);
       String lo = m.hasLower ? String(m.lower) : String("unset");
       String hi = m.hasUpper ? String(m.upper) : String("unset");
@@ -82,36 +332,223 @@ static inline void parseSingle(char *cmd) {
                     " lo=" + lo + " hi=" + hi +
                     " vel=" + String(m.velocity) + " accel=" + String(m.accel) +
                     " decel=" + String(m.decel) + " peak=" + String(m.peakCurr) +
-                    " micro=" + String(m.microstep);
+                    " micro=" + String(m.microstep) +
+                    " hold=" + (m.holdMode == HOLD_STANDBY ? "standby" : "disable") +
+                    " sbcur=" + String(m.standbyPct) +
+                    (m.alarm ? " alarm=0x" + String(m.alarm, HEX) : String("")) +
+                    (healthQuarantined(id) ? " QUARANTINED" : "");
       printLineBoth(info);
     }
     printLineBoth("======================");
     return;
   }
 
-  // Global: read error codes from all drivers
-  if (ieqStr(cmd, "read errors")) {
+  // Global: driver alarms "read errors" (background-scan cache) | "read errors fresh" (re-read now)
+  if (ieqStr(cmd, "read errors") || ieqStr(cmd, "read errors fresh")) {
+    const bool fresh = (cmd[11] != '\0');
+    if (fresh && refuseWhileBooting()) return;
     printLineBoth("=== DRIVER ERROR CHECK ===");
     bool hasErrors = false;
-    for (uint8_t id = 1; id <= 22; ++id) {
-      uint16_t errorCode = readReg(id, REG_ALARM_STATUS);
-      delay(10);  // Small delay to avoid serial buffer overrun
-      if (errorCode != 0) {
+    uint32_t oldest = 0;
+    for (uint8_t i = 0; i < g_axes.count; ++i) {
+      const uint8_t id = g_axes.ids[i];
+      if (fresh) alarmReadNow(id);
+      const AlarmCache &c = g_alarm[id];
+      if (!c.atMs) { printLineBoth("m" + String(id) + ": not scanned yet"); continue; }
+      if (millis() - c.atMs > oldest) oldest = millis() - c.atMs;
+      if (c.noReply) {
+        hasErrors = true;
+        printLineBoth("m" + String(id) + ": no reply" + (healthQuarantined(id) ? " (quarantined)" : ""));
+      } else if (mById(id).alarm != 0) {
         hasErrors = true;
-        printLineBoth("m" + String(id) + ": ERROR 0x" + String(errorCode, HEX));
+        printLineBoth("m" + String(id) + ": ERROR 0x" + String(mById(id).alarm, HEX));
       }
     }
     if (!hasErrors) {
       printLineBoth("All drivers OK - no errors");
     }
+    if (!fresh) printLineBoth("(cached, oldest " + String(oldest) + " ms)");
     printLineBoth("==========================");
     return;
   }
 
+  // Global: per-slave Modbus statistics "bus stats" | "bus stats clear"
+  if (ieqStr(cmd, "bus stats")) {
+    printLineBoth("=== BUS STATS ===");
+    for (uint8_t id = 1; id <= MAX_AXES; ++id) {
+      const BusStats &b = g_busStats[id];
+      if (!b.writes && !b.reads) continue;
+      printLineBoth("m" + String(id) + ": writes=" + String(b.writes) + " retries=" + String(b.retries) +
+                    " fail=" + String(b.failures) + " reads=" + String(b.reads) +
+                    " readfail=" + String(b.readFails) + " exc=" + String(b.exceptions) +
+                    (b.exceptions ? " last=" + String(b.lastExc) : String("")) +
+                    (b.skipped ? " skipped=" + String(b.skipped) : String("")) + healthStatus(id));
+    }
+    for (uint8_t k = 0; k < MB_RX_PORTS; ++k) {
+      const MbRxStats &x = g_mbRx[k].stats;
+      printLineBoth(String("rx ") + (k == 0 ? "A" : "B") + ": frames=" + String(x.frames) +
+                    " crc=" + String(x.crcErrors) + " overrun=" + String(x.overruns) +
+                    " dropped=" + String(x.dropped) + " stray=" + String(x.stray));
+    }
+    printLineBoth("=================");
+    return;
+  }
+  // Global: axis table "bus axes" | re-scan the buses "bus scan" (admin mode)
+  if (ieqStr(cmd, "bus axes")) { printLineBoth("bus " + axisTableSummary()); return; }
+  if (ieqStr(cmd, "bus scan")) {
+    if (refuseWhileBooting()) return;
+    if (!g_adminMode) {
+      printLineBoth("ERROR: Admin mode required to scan the bus. Use 'admin on' first.");
+      return;
+    }
+    for (uint8_t i = 0; i < g_axes.count; ++i) {
+      if (mById(g_axes.ids[i]).moving) { printLineBoth("err=busy"); return; }
+    }
+    const uint32_t t0 = millis();
+    busScan();
+    nvSaveAxisTable();
+    printLineBoth("bus scan: " + axisTableSummary() + " (" + String(millis() - t0) + " ms)");
+    initAllDrivers();
+    return;
+  }
+
+  // Global: RS-485 rate migration "bus baud <rate>" (admin mode) | "bus baud"
+  if (strncasecmp(cmd, "bus baud", 8) == 0 && (cmd[8] == ' ' || cmd[8] == '\0')) {
+    if (cmd[8] == '\0') { printLineBoth(baudStatus()); return; }
+    if (refuseWhileBooting()) return;
+    if (!g_adminMode) {
+      printLineBoth("ERROR: Admin mode required to change the bus rate. Use 'admin on' first.");
+      return;
+    }
+    const char *err = busMigrateBaud((uint32_t)atol(cmd + 9));
+    if (err) { printLineBoth("err=" + String(err) + ", " + baudStatus()); return; }
+    printLineBoth(baudStatus());
+    return;
+  }
+  if (ieqStr(cmd, "bus stats clear")) {
+    memset(g_busStats, 0, sizeof(g_busStats));
+    mbRxClearStats();
+    printLineBoth("bus stats cleared");
+    return;
+  }
+
+  // Global: telemetry stream "telemetry <period_ms>" | "telemetry off" | "telemetry"
+  if (strncasecmp(cmd, "telemetry", 9) == 0 && (cmd[9] == ' ' || cmd[9] == '\0')) {
+    if (cmd[9] == ' ' && ieqStr(cmd + 10, "off")) telemetryStop();
+    else if (cmd[9] == ' ' && atol(cmd + 10) > 0) telemetryStart((uint32_t)atol(cmd + 10));
+    printLineBoth(g_tlmPeriodMs ? "telemetry=" + String(g_tlmPeriodMs) + "ms" : String("telemetry=off"));
+    return;
+  }
+
+  // Global: motion history "history m<id> [n]"
+  if (strncasecmp(cmd, "history m", 9) == 0) {
+    char *end = nullptr;
+    const long id = strtol(cmd + 9, &end, 10);
+    if (id < 1 || id > MAX_AXES) { printLineBoth("history, err=BadId"); return; }
+    long n = (end && *end) ? atol(end) : HIST_QUERY_DEFAULT;
+    if (n <= 0) n = HIST_QUERY_DEFAULT;
+    if (n > (long)HIST_QUERY_MAX) n = HIST_QUERY_MAX;
+    historyQuery((uint8_t)id, (uint16_t)n);
+    return;
+  }
+
+  // Global: move coalescing "coalesce <ms>" (all axes) | "coalesce" (stats)
+  if (strncasecmp(cmd, "coalesce", 8) == 0 && (cmd[8] == ' ' || cmd[8] == '\0')) {
+    if (cmd[8] == ' ') {
+      const uint16_t ms = (uint16_t)constrain(atol(cmd + 9), 0L, (long)COALESCE_MAX_MS);
+      for (uint8_t id = 1; id <= MAX_AXES; ++id) g_coalesceMs[id] = ms;
+    }
+    printLineBoth("=== COALESCE ===");
+    for (uint8_t i = 0; i < g_axes.count; ++i) {
+      const uint8_t id = g_axes.ids[i];
+      const CoalesceStats &c = g_coalesceStats[id];
+      printLineBoth("m" + String(id) + ": window=" + String(g_coalesceMs[id]) + "ms moves=" + String(c.moves) +
+                    " issued=" + String(c.issued) + " merged=" + String(c.merged));
+    }
+    printLineBoth("================");
+    return;
+  }
+
+  // Global: flight recorder "trace" | "trace dump" | "trace clear" | "trace freeze on|off" | "trace resume"
+  if (strncasecmp(cmd, "trace", 5) == 0 && (cmd[5] == ' ' || cmd[5] == '\0')) {
+    const char *arg = cmd[5] ? cmd + 6 : "";
+    if (ieqStr(arg, "dump")) { traceDump(printLineBoth); return; }
+    if (ieqStr(arg, "clear"))           { g_traceHead = 0; g_traceFrozen = false; }
+    else if (ieqStr(arg, "resume"))     g_traceFrozen = false;
+    else if (ieqStr(arg, "freeze on"))  g_traceFreezeOnAlarm = true;
+    else if (ieqStr(arg, "freeze off")) g_traceFreezeOnAlarm = false;
+    printLineBoth("trace=" + String(g_traceHead) + " events, " + (g_traceFrozen ? "frozen" : "recording") +
+                  ", freeze on alarm=" + (g_traceFreezeOnAlarm ? "on" : "off"));
+    return;
+  }
+
   // Global: laser
   if (ieqStr(cmd, "laser on"))  { laserSet(true);  printLineBoth("laser=on");  return; }
   if (ieqStr(cmd, "laser off")) { laserSet(false); printLineBoth("laser=off"); return; }
   if (ieqStr(cmd, "laser"))     { printLineBoth(laserIsOn() ? "laser=on" : "laser=off"); return; }
+  if (ieqStr(cmd, "laser pulses")) { laserPrintLog(printLineBoth); return; }
+
+  // Timed laser pulse: "laser pulse <us>" | "laser pulse <us> after m1 m2 done" | "laser pulse off" (disarm)
+  if (strncasecmp(cmd, "laser pulse ", 12) == 0) {
+    char *t = strtok(cmd + 12, " ,\t");
+    if (ieqStr(t, "off")) { laserDisarm(); printLineBoth("laser pulse disarmed"); return; }
+    const long us = t ? atol(t) : 0;
+    if (us <= 0 || (uint32_t)us > LASER_PULSE_MAX_US) { printLineBoth("laser pulse, err=LaserPulseRange"); return; }
+
+    char *t2 = strtok(nullptr, " ,\t");
+    if (!t2) {
+      const char *err = laserPulse((uint32_t)us);
+      printLineBoth(err ? String("laser pulse, err=") + err : "laser pulse " + String(us) + "us");
+      return;
+    }
+    if (!ieqStr(t2, "after")) { printLineBoth("laser pulse, err=LaserSyntax"); return; }
+    if (laserIsOn()) { printLineBoth("laser pulse, err=LaserOn"); return; }   // would only fail when it fires
+    uint64_t mask = 0;
+    String axes;
+    for (char *a = strtok(nullptr, " ,\t"); a && !ieqStr(a, "done"); a = strtok(nullptr, " ,\t")) {
+      const uint8_t aid = (a[0] == 'M' || a[0] == 'm') ? (uint8_t)atoi(a + 1) : 0;
+      if (!axisPresent(aid)) { printLineBoth("laser pulse, err=NoAxis"); return; }
+      if (!mById(aid).moving) continue;          // already stopped: nothing to wait for
+      mask |= (uint64_t)1 << aid;
+      axes += " m" + String(aid);
+    }
+    if (!mask) {
+      const char *err = laserPulse((uint32_t)us);
+      printLineBoth(err ? String("laser pulse, err=") + err : "laser pulse " + String(us) + "us");
+      return;
+    }
+    laserArm(mask, (uint32_t)us);
+    printLineBoth("laser pulse " + String(us) + "us armed after" + axes);
+    return;
+  }
+
+  // Global: SD motion scripts "script run <name>" | "script abort" | "script status" | "script list"
+  if (strncasecmp(cmd, "script", 6) == 0 && (cmd[6] == ' ' || cmd[6] == '\0')) {
+    char *t = strtok(cmd + 6, " \t");
+    if (!t || ieqStr(t, "status")) { printLineBoth(scriptStatus()); return; }
+    if (ieqStr(t, "list")) { scriptList(printLineBoth); return; }
+    if (ieqStr(t, "abort")) {
+      printLineBoth(scriptAbort("abort", true) ? scriptStatus() : String("script, err=NotRunning"));
+      return;
+    }
+    if (ieqStr(t, "run")) {
+      if (refuseWhileBooting()) return;
+      char *name = strtok(nullptr, " \t");
+      uint16_t line = 0;
+      const char *err = scriptStart(name ? name : "", line);
+      if (err) {
+        printLineBoth("script, err=" + String(err) + (line ? " at line " + String(line) : String("")));
+        return;
+      }
+      printLineBoth("script " + String(name) + " started, " + String(g_scriptLen) + " bytes");
+      return;
+    }
+    printLineBoth("script, err=BadCommand");
+    return;
+  }
+
+  // Global: driver parameter snapshots on SD "drv backup|verify|restore ..."
+  if (strncasecmp(cmd, "drv ", 4) == 0) { parseDrv(cmd + 4); return; }
 
   // Fan: FG / FS
   if ((cmd[0] == 'F' || cmd[0] == 'f') && cmd[2] == '\0') {
@@ -123,11 +560,30 @@ static inline void parseSingle(char *cmd) {
   char *tok = strtok(cmd, " ,\t");
   if (!tok || (tok[0] != 'M' && tok[0] != 'm')) return;
   uint8_t id = (uint8_t)atoi(tok + 1);
-  if (id < 1 || id > 22) return;
+  if (!axisValidId(id)) return;
+  if (!axisPresent(id)) { printLineBoth("m" + String(id) + ", err=NoAxis"); return; }
+  if (!bootAxisReady(id)) { printLineBoth("m" + String(id) + ", err=NotReady"); return; }
+  healthProbeNow(id);         // quarantined axis: this command's first transaction probes it
 
   char *t1 = strtok(nullptr, " ,\t");
   if (!t1) return;
 
+  // A queued (coalesced) move goes out before anything else uses the axis; a stop drops it
+  const bool plainMove = isdigit((unsigned char)t1[0]) || t1[0] == '-' || t1[0] == '+' ||
+                         strncasecmp(t1, "MoveTo", 6) == 0;
+  if (ieq1(t1, 's')) coalesceCancel(id);
+  else if (!plainMove) coalesceFlush(id);
+
+  // Coalescing window: "coalesce <ms>" | "coalesce"
+  if (ieqStr(t1, "coalesce")) {
+    char *t2 = strtok(nullptr, " ,\t");
+    if (t2) g_coalesceMs[id] = (uint16_t)constrain(atol(t2), 0L, (long)COALESCE_MAX_MS);
+    const CoalesceStats &c = g_coalesceStats[id];
+    printLineBoth("m" + String(id) + ", coalesce=" + String(g_coalesceMs[id]) + "ms, moves=" + String(c.moves) +
+                  ", issued=" + String(c.issued) + ", merged=" + String(c.merged));
+    return;
+  }
+
   // Polling toggle: "st t|f"
   if (ieq2(t1, 's', 't')) {
     char *t2 = strtok(nullptr, " ,\t");
@@ -145,7 +601,21 @@ static inline void parseSingle(char *cmd) {
   }
 
   // Read SD-stored endpoints + current RAM position: "read"
+  // Driver configuration registers: "read cfg [maxage_ms]" (served from the shadow when fresh enough)
   if (ieqStr(t1, "read")) {
+    char *t2 = strtok(nullptr, " ,\t");
+    if (t2 && ieqStr(t2, "cfg")) {
+      char *t3 = strtok(nullptr, " ,\t");
+      uint32_t maxAge = t3 ? (uint32_t)atol(t3) : SHADOW_READ_MAX_AGE_MS;
+      String info = "m" + String(id) + ", cfg";
+      for (uint8_t i = 0; i < SH_COUNT; ++i) {
+        uint16_t v;
+        info += " 0x" + String(kShadowRegs[i], HEX) + "=";
+        info += readRegCached(id, kShadowRegs[i], maxAge, v) ? String(v) : String("err");
+      }
+      printLineBoth(info);
+      return;
+    }
     printLineBoth(fmtStatus(id));
     return;
   }
@@ -156,6 +626,7 @@ static inline void parseSingle(char *cmd) {
     if (!t2) return;
     MotorState &m = mById(id);
     if (ieqStr(t2, "lo")) {
+      m.absOrigin -= m.position;   // keep the driver's absolute frame aligned
       m.position = 0;
       m.lower = 0;
       m.hasLower = true;
@@ -174,11 +645,91 @@ static inline void parseSingle(char *cmd) {
     return;
   }
 
+  // Constant-velocity tracking: "track <rpm>" starts or retargets, "track" reports
+  if (ieqStr(t1, "track")) {
+    char *t2 = strtok(nullptr, " ,\t");
+    if (!t2) {
+      const TrackState &t = g_track[id];
+      printLineBoth("m" + String(id) + ", track " + (t.active ? "rpm=" + String(t.rpm) : String("off")) +
+                    ", pos=" + String(mById(id).position));
+      return;
+    }
+    if (ieqStr(t2, "off")) {
+      if (trackActive(id)) trackStop(id, "stopped");
+      else printLineBoth(fmtStatus(id));
+      return;
+    }
+    const long rpm = atol(t2);
+    if (rpm < -(long)TRACK_MAX_RPM || rpm > (long)TRACK_MAX_RPM) {
+      printLineBoth("m" + String(id) + ", err=TrackRpmRange");
+      return;
+    }
+    if (!trackActive(id) && (mById(id).moving || homingActive(id))) {
+      printLineBoth("m" + String(id) + ", err=busy");
+      return;
+    }
+    const char *err = trackSet(id, (int16_t)rpm);
+    if (err) { printLineBoth("m" + String(id) + ", err=" + err); return; }
+    printLineBoth("m" + String(id) + ", track rpm=" + String(rpm) + ", pos=" + String(mById(id).position));
+    return;
+  }
+
+  // Preloaded PR paths:
+  //   "path upload <name> <steps[:rpm[:dwell_ms]]> ..."  "path run <name>"  "path list"  "path clear"
+  if (ieqStr(t1, "path")) {
+    char *t2 = strtok(nullptr, " ,\t");
+    if (!t2) return;
+    if (ieqStr(t2, "upload")) {
+      char *name = strtok(nullptr, " ,\t");
+      if (!name) { printLineBoth("err=PathMissingName"); return; }
+      PrSegment segs[PR_SLOT_COUNT - 1];
+      uint8_t n = 0;
+      for (char *t = strtok(nullptr, " ,\t"); t; t = strtok(nullptr, " ,\t")) {
+        if (n >= PR_SLOT_COUNT - 1 || !pathParseSegment(id, t, segs[n])) {
+          printLineBoth("m" + String(id) + ", err=PathBadSegment");
+          return;
+        }
+        ++n;
+      }
+      const char *err = pathUpload(id, name, segs, n);
+      if (err) { printLineBoth("m" + String(id) + ", err=" + err); return; }
+      printLineBoth("m" + String(id) + ", path " + name + " uploaded, " + String(n) + " segments");
+      return;
+    }
+    if (ieqStr(t2, "run")) {
+      char *name = strtok(nullptr, " ,\t");
+      if (!name) { printLineBoth("err=PathMissingName"); return; }
+      if (trackActive(id)) { printLineBoth("m" + String(id) + ", err=Tracking"); return; }
+      const char *err = pathRun(id, name);
+      if (err) { printLineBoth("m" + String(id) + ", err=" + err); return; }
+      printLineBoth(fmtStatus(id));
+      return;
+    }
+    if (ieqStr(t2, "list")) {
+      for (uint8_t i = 0; i < PR_PATH_MAX; ++i) {
+        const PrPath &p = g_paths[i];
+        if (!p.name[0] || p.id != id) continue;
+        printLineBoth("m" + String(id) + ", path " + p.name + " slots=" + String(p.firstSlot) + ".." +
+                      String(p.firstSlot + p.count - 1) + " net=" + String(p.net) +
+                      (p.epoch == g_driverEpoch[id] ? "" : " (lost)"));
+      }
+      return;
+    }
+    if (ieqStr(t2, "clear")) {
+      pathClearAxis(id);
+      printLineBoth("m" + String(id) + ", paths cleared");
+      return;
+    }
+    return;
+  }
+
   // Send driver configuration: "send cfg"
   if (ieqStr(t1, "send")) {
     char *t2 = strtok(nullptr, " ,\t");
     if (t2 && ieqStr(t2, "cfg")) {
-      // Re-apply hard-coded driver parameters to this DM556RS
+      if (trackActive(id)) { printLineBoth("m" + String(id) + ", err=Tracking"); return; }
+      // Re-apply driver parameters to this DM556RS (forced: bypass the shadow)
+      shadowInvalidate(id);
       initDriver(id);
       printLineBoth("m" + String(id) + ", cfg_sent");
     }
@@ -204,43 +755,13 @@ static inline void parseSingle(char *cmd) {
       p = t2;
     }
 
-    long target = atol(p);
-    MotorState &m = mById(id);
-
-    // Apply soft limits in absolute space if not in admin mode
-    if (!g_adminMode) {
-      if (m.hasLower && target < m.lower) target = m.lower;
-      if (m.hasUpper && target > m.upper) target = m.upper;
-    }
-
-    long steps = target - m.position;
-
-    if (!g_adminMode) {
-      // Respect direction blocks
-      if (steps < 0 && m.blockNeg) { printLineBoth(fmtStatus(id)); return; }
-      if (steps > 0 && m.blockPos) { printLineBoth(fmtStatus(id)); return; }
-    }
-
-    if (steps == 0) {
-      // Already at (clamped) target
-      printLineBoth(fmtStatus(id));
-      return;
-    }
-
-    // Report what we are about to do
-    String info = "m" + String(id) +
-                  ", moveto target=" + String(target) +
-                  ", steps=" + String(steps);
-    printLineBoth(info);
-
-    enableMotorHW(id);
-    moveMotor(id, steps);
-    printLineBoth(fmtStatus(id));
+    cmdMoveAbs(id, atol(p));
     return;
   }
 
-  // Engineering mode: "m1, vel=100, accel=100, decel=100, mcurr=1, hcurr=0"
+  // Engineering mode: "m1, vel=100, accel=100, decel=100, peak=10, micro=51200, hold=standby, sbcur=50"
   if (g_engineeringMode && strchr(t1, '=')) {
+    if (trackActive(id)) { printLineBoth("m" + String(id) + ", err=Tracking"); return; }
     // This is a key=value parameter, parse engineering parameters
     MotorState &m = mById(id);
     uint16_t new_vel = m.velocity;
@@ -248,6 +769,8 @@ static inline void parseSingle(char *cmd) {
     uint16_t new_decel = m.decel;
     uint16_t new_peak = m.peakCurr;
     uint16_t new_micro = m.microstep;
+    uint8_t  new_hold  = m.holdMode;
+    uint8_t  new_sbcur = m.standbyPct;
     
     // Parse t1 first (could be "vel=100")
     char *eq = strchr(t1, '=');
@@ -259,6 +782,11 @@ static inline void parseSingle(char *cmd) {
       else if (ieqStr(t1, "decel")) new_decel = (uint16_t)val;
       else if (ieqStr(t1, "peak"))  new_peak = (uint16_t)val;
       else if (ieqStr(t1, "micro")) new_micro = (uint16_t)val;
+      else if (ieqStr(t1, "sbcur")) new_sbcur = (uint8_t)constrain(val, 1, 100);
+      else if (ieqStr(t1, "hold")) {
+        if (ieqStr(eq + 1, "standby"))      new_hold = HOLD_STANDBY;
+        else if (ieqStr(eq + 1, "disable")) new_hold = HOLD_DISABLE;
+      }
     }
     
     // Parse remaining tokens
@@ -273,6 +801,11 @@ static inline void parseSingle(char *cmd) {
         else if (ieqStr(tok, "decel")) new_decel = (uint16_t)val;
         else if (ieqStr(tok, "peak"))  new_peak = (uint16_t)val;
         else if (ieqStr(tok, "micro")) new_micro = (uint16_t)val;
+        else if (ieqStr(tok, "sbcur")) new_sbcur = (uint8_t)constrain(val, 1, 100);
+        else if (ieqStr(tok, "hold")) {
+          if (ieqStr(eq + 1, "standby"))      new_hold = HOLD_STANDBY;
+          else if (ieqStr(eq + 1, "disable")) new_hold = HOLD_DISABLE;
+        }
       }
       tok = strtok(nullptr, " ,\t");
     }
@@ -284,15 +817,26 @@ static inline void parseSingle(char *cmd) {
     m.peakCurr = new_peak;
     m.microstep = new_micro;
     
+    const bool holdChanged = (new_hold != m.holdMode) || (new_sbcur != m.standbyPct);
+    m.holdMode = new_hold;
+    m.standbyPct = new_sbcur;
+
     // Save to SD card
     nvSaveMotorParams(id, new_vel, new_accel, new_decel, new_peak, new_micro);
+    if (holdChanged) nvSaveHold(id, new_hold, new_sbcur);
+
+    // Idle policy: standby axes never auto-disable; disable axes restart the countdown if idle
+    if (new_hold == HOLD_STANDBY) disableTimerCancel(id);
+    else if (m.enabled && !m.moving && !disableTimerArmed(id)) disableTimerArm(id, millis() + DISABLE_TIMEOUT_MS);
     
     // Apply to hardware
     initDriver(id);
     
     String resp = "m" + String(id) + ", vel=" + String(new_vel) +
                   ", accel=" + String(new_accel) + ", decel=" + String(new_decel) +
-                  ", peak=" + String(new_peak) + ", micro=" + String(new_micro, HEX);
+                  ", peak=" + String(new_peak) + ", micro=" + String(new_micro, HEX) +
+                  ", hold=" + (new_hold == HOLD_STANDBY ? "standby" : "disable") +
+                  ", sbcur=" + String(new_sbcur);
     printLineBoth(resp);
     return;
   }
@@ -305,45 +849,74 @@ static inline void parseSingle(char *cmd) {
 
   // Quick stop: "s"
   if (ieq1(t1, 's')) {
-    stopMotor(id);
+    if (trackActive(id)) trackStop(id, "stopped");
+    else stopMotor(id);
+    homingAbort(id);
     printLineBoth(fmtStatus(id));
     return;
   }
 
   // Default: steps with limits unless admin mode ON
-  long steps = atol(t1);
-  if (steps == 0) {
-    printLineBoth(fmtStatus(id));
-    return;
-  }
-
-  MotorState &m = mById(id);
+  cmdMoveRel(id, atol(t1));
+}
 
-  if (!g_adminMode) {
-    if (steps < 0 && m.blockNeg) { printLineBoth(fmtStatus(id)); return; }
-    if (steps > 0 && m.blockPos) { printLineBoth(fmtStatus(id)); return; }
+// ─── Coordinated batch: "sync m1, 4000 + m2, -1000 + m3, MoveTo 2500" ──
+static inline void parseSync(char *line) {
+  if (refuseWhileBooting()) return;
+  MoveSpec mv[MAX_AXES];
+  uint8_t  nm = 0;
+
+  // Split on '+' first: strtok state is needed per segment
+  char *segs[MAX_AXES];
+  uint8_t ns = 0;
+  for (char *p = line; p && ns < MAX_AXES; ) {
+    segs[ns++] = p;
+    p = strchr(p, '+');
+    if (p) *p++ = '\0';
+  }
 
-    int32_t desired = m.position + steps;
-    if (steps < 0 && m.hasLower && desired < m.lower) {
-      steps = m.lower - m.position;   // clamp ≤ 0
-    }
-    if (steps > 0 && m.hasUpper && desired > m.upper) {
-      steps = m.upper - m.position;   // clamp ≥ 0
-    }
-    if (steps == 0) {
-      printLineBoth(fmtStatus(id));
-      return;
+  for (uint8_t k = 0; k < ns; ++k) {
+    char *tok = strtok(segs[k], " ,\t\r\n");
+    char *t1  = strtok(nullptr, " ,\t\r\n");
+    char *t2  = strtok(nullptr, " ,\t\r\n");
+    if (!tok || !t1 || (tok[0] != 'M' && tok[0] != 'm')) continue;
+    mv[nm].id = (uint8_t)atoi(tok + 1);
+    if (strncasecmp(t1, "MoveTo", 6) == 0) {
+      const char *p = t1[6] ? t1 + 6 : t2;
+      if (!p) continue;
+      mv[nm].absolute = true;
+      mv[nm].value    = atol(p);
+    } else {
+      mv[nm].absolute = false;
+      mv[nm].value    = atol(t1);
     }
+    ++nm;
   }
-
-  enableMotorHW(id);
-  moveMotor(id, steps);
-  printLineBoth(fmtStatus(id));
+  cmdSync(mv, nm);
 }
 
 // ─── Line parser (+ delimiter) ──────────────────────────────────────
+// One command with its optional "#<tag>" (tags.h)
+static inline void parseSingle(char *cmd) {
+  if (!tagBegin(cmd)) return;
+  parseCommand(cmd);
+  tagEnd();
+}
+
 static inline void parseLine(char *line) {
-  char token[64];
+  // "[#<tag>] sync ...": the whole line is one coordinated batch
+  char *p = line;
+  if (*p == '#') {
+    while (*p && *p != ' ' && *p != '\t') ++p;
+    while (*p == ' ' || *p == '\t') ++p;
+  }
+  if (strncasecmp(p, "sync ", 5) == 0) {
+    char *cmd = line;
+    if (tagBegin(cmd)) { parseSync(cmd + 5); tagEnd(); }
+    return;
+  }
+
+  char token[MAX_PACKET_LENGTH];
   uint8_t idx = 0;
   for (char *p = line; *p; ++p) {
     char c = *p;
@@ -0,0 +1,174 @@
+#ifndef PR_PATHS_H
+#define PR_PATHS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "driver_io.h"
+#include "nv_store.h"
+#include "runtime_state.h"
+
+/* ── Preloaded multi-segment PR paths ────────────────────────────────
+   The DM556RS has 16 PR slots; PR0 is used for single moves, PR1..PR15
+   are free. "m1, path upload scanA 1000:60:200 -1000:60:200" writes one
+   relative segment per slot (target steps, RPM, dwell ms), each slot
+   chained to the next with the PR jump bits, one FC 0x10 frame per
+   slot. "m1, path run scanA" then costs a single trigger frame for the
+   whole sequence instead of a load + trigger per point.
+
+   Names and slot allocation live in controller RAM. Slot contents are
+   lost when a driver power-cycles, so a path uploaded before the last
+   driverStateLost() refuses to run until it is uploaded again.
+*/
+struct PrSegment {
+  int32_t  steps;
+  uint16_t rpm;
+  uint16_t dwellMs;
+};
+
+struct PrPath {
+  char     name[PR_PATH_NAME_LEN];   // "" = free entry
+  uint8_t  id;
+  uint8_t  firstSlot;
+  uint8_t  count;
+  uint16_t maxDwell;   // longest dwell, for move-completion settling
+  uint32_t epoch;      // g_driverEpoch[id] at upload
+  int32_t  net;        // displacement of the whole path
+  int32_t  minOff;     // lowest / highest point relative to the start
+  int32_t  maxOff;
+};
+
+static PrPath   g_paths[PR_PATH_MAX];
+static uint16_t g_prSlotsUsed[MAX_AXES + 1];     // bit n = PR slot n taken (bit 0 = PR0, always reserved)
+
+static inline PrPath *pathFind(uint8_t id, const char *name) {
+  for (uint8_t i = 0; i < PR_PATH_MAX; ++i) {
+    PrPath &p = g_paths[i];
+    if (p.name[0] && p.id == id && strcasecmp(p.name, name) == 0) return &p;
+  }
+  return nullptr;
+}
+
+static inline void pathFree(PrPath &p) {
+  for (uint8_t s = 0; s < p.count; ++s) g_prSlotsUsed[p.id] &= (uint16_t)~(1u << (p.firstSlot + s));
+  p.name[0] = '\0';
+}
+
+static inline void pathClearAxis(uint8_t id) {
+  for (uint8_t i = 0; i < PR_PATH_MAX; ++i) {
+    if (g_paths[i].name[0] && g_paths[i].id == id) pathFree(g_paths[i]);
+  }
+}
+
+// First slot of a free run of `count` slots in 1..15, or 0 if none
+static inline uint8_t pathAllocSlots(uint8_t id, uint8_t count) {
+  const uint16_t used = g_prSlotsUsed[id] | 0x0001;
+  for (uint8_t first = 1; first + count <= PR_SLOT_COUNT; ++first) {
+    bool ok = true;
+    for (uint8_t s = 0; s < count && ok; ++s) ok = !(used & (1u << (first + s)));
+    if (ok) return first;
+  }
+  return 0;
+}
+
+// "steps[:rpm[:dwell_ms]]"; rpm defaults to the axis velocity, dwell to 0
+static inline bool pathParseSegment(uint8_t id, const char *tok, PrSegment &seg) {
+  char *end = nullptr;
+  seg.steps   = strtol(tok, &end, 10);
+  seg.rpm     = mById(id).velocity;
+  seg.dwellMs = 0;
+  if (end == tok) return false;
+  if (*end == ':') {
+    const char *p = end + 1;
+    long v = strtol(p, &end, 10);
+    if (end != p && v > 0) seg.rpm = (uint16_t)v;
+    if (*end == ':') {
+      p = end + 1;
+      v = strtol(p, &end, 10);
+      if (end != p && v >= 0) seg.dwellMs = (uint16_t)min(v, 65535L);
+    }
+  }
+  return *end == '\0';
+}
+
+// Upload segs[0..n) as path `name` on axis id. Returns nullptr or an error tag.
+static inline const char *pathUpload(uint8_t id, const char *name, const PrSegment *segs, uint8_t n) {
+  if (n == 0) return "PathEmpty";
+  if (strlen(name) >= PR_PATH_NAME_LEN) return "PathNameTooLong";
+
+  // Re-upload of an existing name replaces it, but only once the new copy
+  // is complete: it goes to other slots and the old one stays usable on failure
+  PrPath *old = pathFind(id, name);
+  PrPath *p   = old;
+  for (uint8_t i = 0; i < PR_PATH_MAX && !p; ++i) {
+    if (!g_paths[i].name[0]) p = &g_paths[i];
+  }
+  if (!p) return "PathTableFull";
+
+  const uint8_t first = pathAllocSlots(id, n);
+  if (!first) return "PathNoSlots";
+
+  const MotorState &m = mById(id);
+  int32_t  off = 0, lo = 0, hi = 0;
+  uint16_t maxDwell = 0;
+  for (uint8_t i = 0; i < n; ++i) {
+    const uint8_t slot = (uint8_t)(first + i);
+    const uint8_t next = (i + 1 < n) ? (uint8_t)(slot + 1) : 0;
+    uint8_t f[MB_WRITE_MULTI_FRAME_MAX];
+    uint8_t len = buildPRSlotFrame(id, slot, PR0_MODE_REL_POS, segs[i].steps, segs[i].rpm,
+                                   m.accel, m.decel, segs[i].dwellMs, next, f);
+    if (!tx(f, len)) return "NoAck";
+
+    off += segs[i].steps;
+    if (off < lo) lo = off;
+    if (off > hi) hi = off;
+    if (segs[i].dwellMs > maxDwell) maxDwell = segs[i].dwellMs;
+  }
+
+  if (old) pathFree(*old);
+  strncpy(p->name, name, PR_PATH_NAME_LEN - 1);
+  p->name[PR_PATH_NAME_LEN - 1] = '\0';
+  p->id        = id;
+  p->firstSlot = first;
+  p->count     = n;
+  p->epoch     = g_driverEpoch[id];
+  p->maxDwell  = maxDwell;
+  p->net       = off;
+  p->minOff    = lo;
+  p->maxOff    = hi;
+  for (uint8_t s = 0; s < n; ++s) g_prSlotsUsed[id] |= (uint16_t)(1u << (first + s));
+  return nullptr;
+}
+
+// Run a preloaded path with one trigger frame. Returns nullptr or an error tag.
+static inline const char *pathRun(uint8_t id, const char *name) {
+  PrPath *p = pathFind(id, name);
+  if (!p) return "PathUnknown";
+  if (p->epoch != g_driverEpoch[id]) return "PathLost";
+
+  MotorState &m = mById(id);
+  if (!g_adminMode) {
+    if (p->minOff < 0 && m.blockNeg) return "Blocked";
+    if (p->maxOff > 0 && m.blockPos) return "Blocked";
+    if (m.hasLower && m.position + p->minOff < m.lower) return "PathOutOfLimits";
+    if (m.hasUpper && m.position + p->maxOff > m.upper) return "PathOutOfLimits";
+  }
+
+  if (!ensureMotorEnabled(id)) return "NoAck";
+  uint8_t f[8];
+  buildTriggerPathFrame(id, p->firstSlot, f);
+  if (!tx(f)) return "NoAck";
+
+  historyMoveBegin(id);
+  tagNoteStart(id);
+  m.lastMoveMs = millis();
+  m.moving   = true;
+  // A stop between segments (dwell, or the brief one between chained segments) is not the end
+  m.settleMs = (uint16_t)min((uint32_t)max((uint32_t)p->maxDwell, (uint32_t)PR_PATH_GAP_MS) + MOTION_POLL_MS, 65535UL);
+  disableTimerCancel(id);
+  m.lastDir  = (p->net > 0) ? 1 : ((p->net < 0) ? -1 : m.lastDir);
+  m.position += p->net;
+  nvSavePosition(id, m.position);
+  return nullptr;
+}
+
+#endif // PR_PATHS_H
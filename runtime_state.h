@@ -1,6 +1,10 @@
 #ifndef RUNTIME_STATE_H
 #define RUNTIME_STATE_H
 #include <Arduino.h>
+#include "config.h"
+
+// How a move ended (monitors.h); ordered so the worst of several is the largest
+enum AxisStop : uint8_t { STOP_DONE = 0, STOP_TIMEOUT, STOP_ABORTED };
 
 struct MotorState {
   uint8_t  id;
@@ -25,9 +29,33 @@ struct MotorState {
   uint16_t decel;      // ms per 1000 RPM
   uint16_t peakCurr;   // 0.1A units (e.g., 5 = 0.5A)
   uint16_t microstep;  // microstep resolution code
+
+  // Motion tracking (set on trigger, cleared when the driver reports stopped)
+  bool     moving;
+  uint16_t settleMs;   // "stopped" must persist this long to count (dwells inside PR paths)
+  bool     stopSent;   // a quick-stop went out during the move: it ends aborted, not done
+
+  // Idle hold policy: HOLD_DISABLE (auto-disable after idle) or HOLD_STANDBY
+  // (stay enabled, driver drops to standbyPct of peak current after its delay)
+  uint8_t  holdMode;
+  uint8_t  standbyPct; // % of peak current while in standby
+
+  // Absolute-mode reference: driver position 0 == controller position absOrigin.
+  // Cleared whenever the driver may have lost its position (timeout, alarm).
+  bool     absSynced;
+  int32_t  absOrigin;
+
+  // Last alarm code read from the driver (REG_ALARM_STATUS), 0 = none
+  uint16_t alarm;
 };
 
-extern MotorState motors[22];
+static const uint8_t HOLD_DISABLE = 0;
+static const uint8_t HOLD_STANDBY = 1;
+
+extern MotorState motors[MAX_AXES];     // index id - 1
+
+// Power-on defaults for every slot (before NV values are loaded)
+void motorStatesInit();
 
 // Provided by main
 MotorState &mById(uint8_t id);
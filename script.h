@@ -0,0 +1,476 @@
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <ctype.h>
+#include <string.h>
+#include <stdlib.h>
+#include "config.h"
+#include "output.h"
+#include "axis_table.h"
+#include "runtime_state.h"
+#include "driver_io.h"
+#include "coord_move.h"
+#include "coalesce.h"
+#include "homing.h"
+#include "laser.h"
+
+extern EthernetClient client;
+extern uint8_t fanSetpoint;
+
+// Provided by parse.h (same moves as the TCP commands, limits and all)
+static inline bool cmdMoveRel(uint8_t id, long steps);
+static inline bool cmdMoveAbs(uint8_t id, long target);
+static inline bool cmdSync(const MoveSpec *mv, uint8_t nm);
+
+/* ── Motion scripts ("script run <name>") ────────────────────────────
+   A script is a text file SCRIPT_DIR/<name>.txt on the SD card, one
+   statement per line ("//" starts a comment):
+
+     m<id>, <steps>                 relative move
+     m<id>, MoveTo <target>         absolute move
+     sync m1, 4000 + m2, MoveTo 0   coordinated batch ("batch" also accepted)
+     wait m<id> [m<id> ...]         until these axes have stopped
+     wait all                       until every axis has stopped
+     sleep <ms>
+     laser on | off | pulse <us>
+     fan on | off
+     repeat [<n>] ... end           loop n times (no n: until aborted)
+
+   "script run" compiles the whole file into bytecode first, so a typo
+   fails before anything moves. Each op is 1 byte opcode + 2 bytes source
+   line + fixed operands. serviceScript() then steps it from loop(): at
+   most one motion op, or SCRIPT_OPS_PER_PASS other ops, per pass; a wait
+   or sleep just returns until it is satisfied. Moves go through the same
+   code as the TCP commands (soft limits, blocks, coalescing) and print
+   the same replies. "script abort" stops the script and the axes it set
+   moving; an emergency stop aborts it too.
+*/
+enum ScriptOp : uint8_t {
+  SOP_END = 0,
+  SOP_MOVE,        // id u8, steps i32
+  SOP_MOVETO,      // id u8, target i32
+  SOP_SYNC,        // n u8, n x (id u8, absolute u8, value i32)
+  SOP_WAIT,        // axis mask u64
+  SOP_WAIT_ALL,
+  SOP_SLEEP,       // ms u32
+  SOP_LASER,       // on u8
+  SOP_PULSE,       // width us u32
+  SOP_FAN,         // on u8
+  SOP_REPEAT,      // count u16 (0 = forever)
+  SOP_NEXT         // loop body address u16
+};
+
+enum ScriptState : uint8_t { SCRIPT_IDLE = 0, SCRIPT_RUNNING, SCRIPT_DONE, SCRIPT_ABORTED, SCRIPT_FAILED };
+
+struct ScriptRun {
+  char        name[SCRIPT_NAME_MAX + 1];
+  ScriptState state;
+  uint16_t    pc;                          // next op
+  uint16_t    line;                        // source line of the current op
+  uint64_t    waitMask;                    // "wait m<id>..." pending
+  bool        waitAll;
+  bool        sleeping;
+  uint32_t    sleepUntil;
+  uint16_t    loopLeft[SCRIPT_LOOP_DEPTH]; // iterations to go (0 = forever)
+  uint8_t     depth;
+  uint64_t    moved;                       // axes this script has set moving
+  uint32_t    startMs;
+  uint32_t    endMs;
+  uint32_t    ops;
+  const char *why;                         // reason for FAILED / ABORTED
+};
+
+static uint8_t   g_scriptCode[SCRIPT_CODE_MAX];
+static uint16_t  g_scriptLen      = 0;
+static bool      g_scriptOverflow = false;
+static ScriptRun g_script;
+
+static inline bool scriptRunning() { return g_script.state == SCRIPT_RUNNING; }
+
+/* ── Compiler ─────────────────────────────────────────────────────── */
+static inline void scriptEmit(const void *p, uint8_t n) {
+  if (g_scriptLen + n > SCRIPT_CODE_MAX) { g_scriptOverflow = true; return; }
+  memcpy(g_scriptCode + g_scriptLen, p, n);
+  g_scriptLen += n;
+}
+static inline void scriptEmit8(uint8_t v)   { scriptEmit(&v, 1); }
+static inline void scriptEmit16(uint16_t v) { scriptEmit(&v, 2); }
+static inline void scriptEmit32(uint32_t v) { scriptEmit(&v, 4); }
+static inline void scriptEmitOp(ScriptOp op, uint16_t line) { scriptEmit8(op); scriptEmit16(line); }
+
+// "m12" -> 12, 0 if not an axis token
+static inline uint8_t scriptAxis(const char *t) {
+  if (!t || (t[0] != 'm' && t[0] != 'M') || !isdigit((unsigned char)t[1])) return 0;
+  char *end = nullptr;
+  const long id = strtol(t + 1, &end, 10);
+  return (*end == '\0' && id >= 1 && id <= MAX_AXES) ? (uint8_t)id : 0;
+}
+
+static inline bool scriptNumber(const char *t, long &v) {
+  if (!t || !*t) return false;
+  char *end = nullptr;
+  v = strtol(t, &end, 10);
+  return *end == '\0';
+}
+
+// "<steps>" | "MoveTo <target>" | "MoveTo<target>" after an axis token (strtok state)
+static inline bool scriptMoveArgs(MoveSpec &mv) {
+  char *t1 = strtok(nullptr, " ,\t");
+  if (!t1) return false;
+  long v;
+  if (strncasecmp(t1, "MoveTo", 6) == 0) {
+    mv.absolute = true;
+    if (!scriptNumber(t1[6] ? t1 + 6 : strtok(nullptr, " ,\t"), v)) return false;
+  } else {
+    mv.absolute = false;
+    if (!scriptNumber(t1, v)) return false;
+  }
+  mv.value = (int32_t)v;
+  return strtok(nullptr, " ,\t") == nullptr;
+}
+
+// Compile one statement; nullptr or an error tag
+static inline const char *scriptCompileLine(char *ln, uint16_t line, uint16_t *loops, uint8_t &depth) {
+  // Coordinated batch: split on '+' before tokenising each segment
+  if (strncasecmp(ln, "sync ", 5) == 0 || strncasecmp(ln, "batch ", 6) == 0) {
+    MoveSpec mv[MAX_AXES];
+    uint8_t  n = 0;
+    for (char *p = strchr(ln, ' ') + 1; p; ) {
+      char *next = strchr(p, '+');
+      if (next) *next++ = '\0';
+      if (n >= MAX_AXES) return "SyncTooLong";
+      mv[n].id = scriptAxis(strtok(p, " ,\t"));
+      if (!mv[n].id || !scriptMoveArgs(mv[n])) return "BadSync";
+      for (uint8_t i = 0; i < n; ++i) {
+        if (mv[i].id == mv[n].id) return "DuplicateAxis";
+      }
+      ++n;
+      p = next;
+    }
+    scriptEmitOp(SOP_SYNC, line);
+    scriptEmit8(n);
+    for (uint8_t i = 0; i < n; ++i) {
+      scriptEmit8(mv[i].id);
+      scriptEmit8(mv[i].absolute);
+      scriptEmit32((uint32_t)mv[i].value);
+    }
+    return nullptr;
+  }
+
+  char *kw = strtok(ln, " ,\t");
+  if (!kw) return "BadStatement";
+  long v;
+
+  const uint8_t id = scriptAxis(kw);
+  if (id) {
+    MoveSpec mv;
+    if (!scriptMoveArgs(mv)) return "BadMove";
+    scriptEmitOp(mv.absolute ? SOP_MOVETO : SOP_MOVE, line);
+    scriptEmit8(id);
+    scriptEmit32((uint32_t)mv.value);
+    return nullptr;
+  }
+  if (strcasecmp(kw, "wait") == 0) {
+    char *t = strtok(nullptr, " ,\t");
+    if (t && strcasecmp(t, "all") == 0) { scriptEmitOp(SOP_WAIT_ALL, line); return nullptr; }
+    uint64_t mask = 0;
+    for (; t; t = strtok(nullptr, " ,\t")) {
+      const uint8_t w = scriptAxis(t);
+      if (!w) return "BadWait";
+      mask |= (uint64_t)1 << w;
+    }
+    if (!mask) return "BadWait";
+    scriptEmitOp(SOP_WAIT, line);
+    scriptEmit(&mask, 8);
+    return nullptr;
+  }
+  if (strcasecmp(kw, "sleep") == 0) {
+    if (!scriptNumber(strtok(nullptr, " ,\t"), v) || v < 0) return "BadSleep";
+    scriptEmitOp(SOP_SLEEP, line);
+    scriptEmit32((uint32_t)v);
+    return nullptr;
+  }
+  if (strcasecmp(kw, "laser") == 0) {
+    char *t = strtok(nullptr, " ,\t");
+    if (t && strcasecmp(t, "pulse") == 0) {
+      if (!scriptNumber(strtok(nullptr, " ,\t"), v) || v <= 0 || (uint32_t)v > LASER_PULSE_MAX_US) return "BadPulse";
+      scriptEmitOp(SOP_PULSE, line);
+      scriptEmit32((uint32_t)v);
+      return nullptr;
+    }
+    if (!t || (strcasecmp(t, "on") != 0 && strcasecmp(t, "off") != 0)) return "BadLaser";
+    scriptEmitOp(SOP_LASER, line);
+    scriptEmit8(strcasecmp(t, "on") == 0);
+    return nullptr;
+  }
+  if (strcasecmp(kw, "fan") == 0) {
+    char *t = strtok(nullptr, " ,\t");
+    if (!t || (strcasecmp(t, "on") != 0 && strcasecmp(t, "off") != 0)) return "BadFan";
+    scriptEmitOp(SOP_FAN, line);
+    scriptEmit8(strcasecmp(t, "on") == 0);
+    return nullptr;
+  }
+  if (strcasecmp(kw, "repeat") == 0) {
+    char *t = strtok(nullptr, " ,\t");
+    v = 0;
+    if (t && (!scriptNumber(t, v) || v < 1 || v > 65535)) return "BadRepeat";
+    if (depth >= SCRIPT_LOOP_DEPTH) return "RepeatTooDeep";
+    scriptEmitOp(SOP_REPEAT, line);
+    scriptEmit16((uint16_t)v);
+    loops[depth++] = g_scriptLen;           // body starts here
+    return nullptr;
+  }
+  if (strcasecmp(kw, "end") == 0) {
+    if (!depth) return "EndWithoutRepeat";
+    scriptEmitOp(SOP_NEXT, line);
+    scriptEmit16(loops[--depth]);
+    return nullptr;
+  }
+  return "BadStatement";
+}
+
+// Compile SCRIPT_DIR/<name>.txt into g_scriptCode; nullptr or an error (errLine set)
+static inline const char *scriptCompile(const char *name, uint16_t &errLine) {
+  errLine = 0;
+  const String path = String(SCRIPT_DIR) + "/" + name + ".txt";
+  File f = SD.open(path.c_str(), FILE_READ);
+  if (!f) return "NoScript";
+
+  g_scriptLen      = 0;
+  g_scriptOverflow = false;
+  uint16_t loops[SCRIPT_LOOP_DEPTH];
+  uint8_t  depth = 0;
+  uint16_t line  = 0;
+  const char *err = nullptr;
+
+  char    buf[SCRIPT_LINE_MAX];
+  uint8_t n = 0;
+  bool    eof = false;
+  while (!err && !eof) {
+    const int c = f.available() ? f.read() : -1;
+    eof = (c < 0);
+    if (!eof && c != '\n') {
+      if (c != '\r' && n < sizeof(buf) - 1) buf[n++] = (char)c;
+      continue;
+    }
+    buf[n] = '\0';
+    n = 0;
+    ++line;
+
+    char *cm = strstr(buf, "//");
+    if (cm) *cm = '\0';
+    char *s = buf;
+    while (*s == ' ' || *s == '\t') ++s;
+    if (!*s) continue;
+    err = scriptCompileLine(s, line, loops, depth);
+    if (!err && g_scriptOverflow) err = "ScriptTooLong";
+  }
+  f.close();
+
+  if (!err && depth) err = "RepeatWithoutEnd";
+  if (err) { errLine = line; return err; }
+  scriptEmitOp(SOP_END, line);
+  return g_scriptOverflow ? "ScriptTooLong" : nullptr;
+}
+
+/* ── Interpreter ──────────────────────────────────────────────────── */
+static inline uint8_t  scriptRd8()  { return g_scriptCode[g_script.pc++]; }
+static inline uint16_t scriptRd16() { uint16_t v; memcpy(&v, g_scriptCode + g_script.pc, 2); g_script.pc += 2; return v; }
+static inline uint32_t scriptRd32() { uint32_t v; memcpy(&v, g_scriptCode + g_script.pc, 4); g_script.pc += 4; return v; }
+
+static inline bool scriptAxisBusy(uint8_t id) {
+  return mById(id).moving || coalescePending(id) || homingActive(id);
+}
+
+static inline bool scriptWaitDone() {
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const uint8_t id = g_axes.ids[i];
+    if ((g_script.waitAll || (g_script.waitMask & ((uint64_t)1 << id))) && scriptAxisBusy(id)) return false;
+  }
+  g_script.waitAll  = false;
+  g_script.waitMask = 0;
+  return true;
+}
+
+static inline void scriptFinish(ScriptState st, const char *why) {
+  g_script.state = st;
+  g_script.why   = why;
+  g_script.endMs = millis();
+  const String head = "script " + String(g_script.name);
+  const String dt   = String(g_script.endMs - g_script.startMs) + " ms";
+  if (st == SCRIPT_DONE)         printLineBoth(head + " done, " + dt);
+  else if (st == SCRIPT_ABORTED) printLineBoth(head + " aborted (" + why + ") at line " + String(g_script.line) + ", " + dt);
+  else                           printLineBoth(head + ", err=" + why + " at line " + String(g_script.line));
+}
+
+static inline void scriptNoteMoved(uint8_t id) {
+  if (scriptAxisBusy(id)) g_script.moved |= (uint64_t)1 << id;
+}
+
+// Execute one op; false = end this pass (motion op issued, blocked, or finished)
+static inline bool scriptStep() {
+  ScriptRun &r = g_script;
+  const ScriptOp op = (ScriptOp)scriptRd8();
+  r.line = scriptRd16();
+  ++r.ops;
+
+  switch (op) {
+    case SOP_MOVE:
+    case SOP_MOVETO: {
+      const uint8_t id  = scriptRd8();
+      const int32_t val = (int32_t)scriptRd32();
+      if (!axisPresent(id)) { scriptFinish(SCRIPT_FAILED, "NoAxis"); return false; }
+      const bool ok = (op == SOP_MOVE) ? cmdMoveRel(id, val) : cmdMoveAbs(id, val);
+      scriptNoteMoved(id);
+      if (!ok) scriptFinish(SCRIPT_FAILED, "MoveFailed");
+      return false;
+    }
+    case SOP_SYNC: {
+      MoveSpec mv[MAX_AXES];
+      const uint8_t n = scriptRd8();
+      for (uint8_t i = 0; i < n; ++i) {
+        mv[i].id       = scriptRd8();
+        mv[i].absolute = scriptRd8() != 0;
+        mv[i].value    = (int32_t)scriptRd32();
+        if (!axisPresent(mv[i].id)) { scriptFinish(SCRIPT_FAILED, "NoAxis"); return false; }
+      }
+      const bool ok = cmdSync(mv, n);
+      for (uint8_t i = 0; i < n; ++i) scriptNoteMoved(mv[i].id);
+      if (!ok) scriptFinish(SCRIPT_FAILED, "SyncFailed");
+      return false;
+    }
+    case SOP_WAIT:
+      memcpy(&r.waitMask, g_scriptCode + r.pc, 8);
+      r.pc += 8;
+      return scriptWaitDone();
+    case SOP_WAIT_ALL:
+      r.waitAll = true;
+      return scriptWaitDone();
+    case SOP_SLEEP:
+      r.sleepUntil = millis() + scriptRd32();
+      r.sleeping   = true;
+      return false;
+    case SOP_LASER:
+      laserSet(scriptRd8() != 0);
+      return true;
+    case SOP_PULSE: {
+      const char *err = laserPulse(scriptRd32());
+      if (err) { scriptFinish(SCRIPT_FAILED, err); return false; }
+      return true;
+    }
+    case SOP_FAN:
+      fanSetpoint = scriptRd8() ? FAN_PRESET : 0;
+      return true;
+    case SOP_REPEAT:
+      r.loopLeft[r.depth++] = scriptRd16();
+      return true;
+    case SOP_NEXT: {
+      const uint16_t body = scriptRd16();
+      uint16_t &left = r.loopLeft[r.depth - 1];
+      if (left == 0 || --left > 0) { r.pc = body; return true; }
+      --r.depth;
+      return true;
+    }
+    case SOP_END:
+    default:
+      scriptFinish(SCRIPT_DONE, "");
+      return false;
+  }
+}
+
+// loop(): advance the running script without blocking
+static inline void serviceScript() {
+  ScriptRun &r = g_script;
+  if (r.state != SCRIPT_RUNNING) return;
+  if (r.sleeping) {
+    if ((int32_t)(millis() - r.sleepUntil) < 0) return;
+    r.sleeping = false;
+  }
+  if ((r.waitAll || r.waitMask) && !scriptWaitDone()) return;
+  for (uint8_t k = 0; k < SCRIPT_OPS_PER_PASS && r.state == SCRIPT_RUNNING; ++k) {
+    if (!scriptStep()) break;
+  }
+}
+
+// Compile and start; nullptr or an error tag (errLine set for compile errors)
+static inline const char *scriptStart(const char *name, uint16_t &errLine) {
+  errLine = 0;
+  if (scriptRunning()) return "ScriptRunning";
+  const size_t len = strlen(name);
+  if (!len || len > SCRIPT_NAME_MAX) return "BadName";
+  for (size_t i = 0; i < len; ++i) {
+    if (!isalnum((unsigned char)name[i]) && name[i] != '_' && name[i] != '-') return "BadName";
+  }
+  const char *err = scriptCompile(name, errLine);
+  if (err) return err;
+
+  memset(&g_script, 0, sizeof(g_script));
+  strcpy(g_script.name, name);
+  g_script.state   = SCRIPT_RUNNING;
+  g_script.startMs = millis();
+  g_script.why     = "";
+  return nullptr;
+}
+
+// stopAxes: quick-stop what the script set moving (not needed after an estop broadcast)
+static inline bool scriptAbort(const char *why, bool stopAxes) {
+  if (!scriptRunning()) return false;
+  if (stopAxes) {
+    for (uint8_t i = 0; i < g_axes.count; ++i) {
+      const uint8_t id = g_axes.ids[i];
+      if (!(g_script.moved & ((uint64_t)1 << id))) continue;
+      coalesceCancel(id);
+      if (mById(id).moving) stopMotor(id);
+    }
+  }
+  scriptFinish(SCRIPT_ABORTED, why);
+  return true;
+}
+
+// "script raster: running, line 7, wait m1 m2, 12400 ms, 341 ops"
+static inline String scriptStatus() {
+  const ScriptRun &r = g_script;
+  if (r.state == SCRIPT_IDLE) return "script: none";
+  String s = "script " + String(r.name) + ": ";
+  switch (r.state) {
+    case SCRIPT_RUNNING: s += "running, line " + String(r.line); break;
+    case SCRIPT_DONE:    s += "done"; break;
+    case SCRIPT_ABORTED: s += "aborted (" + String(r.why) + ") at line " + String(r.line); break;
+    default:             s += "failed (" + String(r.why) + ") at line " + String(r.line); break;
+  }
+  if (r.state == SCRIPT_RUNNING) {
+    if (r.sleeping) {
+      const int32_t left = (int32_t)(r.sleepUntil - millis());
+      s += ", sleep " + String(left > 0 ? left : 0) + " ms left";
+    } else if (r.waitAll) {
+      s += ", wait all";
+    } else if (r.waitMask) {
+      s += ", wait";
+      for (uint8_t id = 1; id <= MAX_AXES; ++id) {
+        if (r.waitMask & ((uint64_t)1 << id)) s += " m" + String(id);
+      }
+    }
+  }
+  const uint32_t end = (r.state == SCRIPT_RUNNING) ? millis() : r.endMs;
+  return s + ", " + String(end - r.startMs) + " ms, " + String(r.ops) + " ops";
+}
+
+// "script list": scripts on the card
+static inline void scriptList(void (*out)(const String &)) {
+  File dir = SD.open(SCRIPT_DIR);
+  if (!dir || !dir.isDirectory()) { out("script list: no " + String(SCRIPT_DIR) + "/ directory"); return; }
+  uint8_t n = 0;
+  for (File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+    if (!f.isDirectory()) {
+      out("script " + String(f.name()) + " (" + String(f.size()) + " bytes)");
+      ++n;
+    }
+    f.close();
+  }
+  dir.close();
+  out("script list: " + String(n) + " files");
+}
+
+#endif // SCRIPT_H
@@ -0,0 +1,123 @@
+#ifndef SLAVE_HEALTH_H
+#define SLAVE_HEALTH_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "output.h"
+
+/* ── Per-slave reply timing and quarantine ───────────────────────────
+   Every answered transaction feeds the slave's turnaround time (reply
+   time minus the bytes on the wire and the closing silent interval)
+   into a smoothed mean and mean deviation, as TCP does for its RTO.
+   Once MB_RTO_SAMPLES replies are in, the reply timeout for that slave
+   becomes wire time + silent interval + srtt + 4 * rttvar, never less
+   than MB_RTO_MIN_US of turnaround and never more than the fixed
+   default the caller passes in. A healthy DM556RS then times out after
+   a few ms instead of 25–50 ms.
+
+   MB_QUARANTINE_MISSES unanswered transactions in a row quarantine the
+   slave: tx() and readRegs() fail at once without touching the bus, and
+   only one probe transaction is let through every backoff period
+   (MB_PROBE_MIN_MS, doubling up to MB_PROBE_MAX_MS). Any reply lifts
+   the quarantine. A command addressed to the axis probes it at once.
+   A baud change starts every slave afresh.
+*/
+struct SlaveHealth {
+  uint32_t srttUs;        // smoothed turnaround
+  uint32_t rttvarUs;      // smoothed mean deviation
+  uint8_t  samples;       // up to MB_RTO_SAMPLES
+  uint8_t  misses;        // consecutive unanswered transactions
+  bool     quarantined;
+  uint32_t sinceMs;       // quarantined at
+  uint32_t nextProbeMs;
+  uint32_t backoffMs;
+};
+
+static SlaveHealth g_health[MAX_AXES + 1];
+
+static inline bool healthTracked(uint8_t id) { return id >= 1 && id <= MAX_AXES; }
+
+static inline void healthReset() {
+  memset(g_health, 0, sizeof(g_health));
+}
+
+static inline bool healthQuarantined(uint8_t id) {
+  return healthTracked(id) && g_health[id].quarantined;
+}
+
+// May a transaction to `id` go on the bus now? For a quarantined slave only when its probe is due
+static inline bool healthAllow(uint8_t id) {
+  if (!healthQuarantined(id)) return true;
+  return (int32_t)(millis() - g_health[id].nextProbeMs) >= 0;
+}
+
+// Command addressed to the axis: let the next transaction through as a probe
+static inline void healthProbeNow(uint8_t id) {
+  if (healthQuarantined(id)) g_health[id].nextProbeMs = millis();
+}
+
+// Turnaround allowance for the reply timeout (coldUs until enough samples)
+static inline uint32_t healthTurnaroundUs(uint8_t id, uint32_t coldUs) {
+  if (!healthTracked(id)) return coldUs;
+  const SlaveHealth &h = g_health[id];
+  if (h.samples < MB_RTO_SAMPLES) return coldUs;
+  uint32_t t = h.srttUs + 4 * h.rttvarUs;
+  if (t < MB_RTO_MIN_US) t = MB_RTO_MIN_US;
+  return t < coldUs ? t : coldUs;
+}
+
+// The slave answered (any reply); turnUs = measured turnaround, or -1 if not a timing sample
+static inline void healthNoteReply(uint8_t id, int32_t turnUs) {
+  if (!healthTracked(id)) return;
+  SlaveHealth &h = g_health[id];
+  if (h.quarantined) {
+    printLineBoth("m" + String(id) + ", bus: answering again (quarantined " +
+                  String((millis() - h.sinceMs) / 1000) + " s)");
+  }
+  h.misses      = 0;
+  h.quarantined = false;
+  if (turnUs < 0) return;
+
+  const uint32_t m = (uint32_t)turnUs;
+  if (h.samples == 0) {
+    h.srttUs   = m;
+    h.rttvarUs = m / 2;
+  } else {
+    const int32_t err = (int32_t)m - (int32_t)h.srttUs;
+    h.srttUs   = (uint32_t)((int32_t)h.srttUs + err / 8);
+    h.rttvarUs = (uint32_t)((int32_t)h.rttvarUs + ((err < 0 ? -err : err) - (int32_t)h.rttvarUs) / 4);
+  }
+  if (h.samples < MB_RTO_SAMPLES) ++h.samples;
+}
+
+// The transaction went unanswered (after its retries)
+static inline void healthNoteTimeout(uint8_t id) {
+  if (!healthTracked(id)) return;
+  SlaveHealth &h = g_health[id];
+  if (h.quarantined) {
+    h.backoffMs   = (h.backoffMs * 2 > MB_PROBE_MAX_MS) ? MB_PROBE_MAX_MS : h.backoffMs * 2;
+    h.nextProbeMs = millis() + h.backoffMs;
+    return;
+  }
+  if (++h.misses < MB_QUARANTINE_MISSES) return;
+  h.quarantined = true;
+  h.sinceMs     = millis();
+  h.backoffMs   = MB_PROBE_MIN_MS;
+  h.nextProbeMs = millis() + h.backoffMs;
+  printLineBoth("m" + String(id) + ", bus: no reply " + String(h.misses) + "x, quarantined");
+}
+
+// " srtt=900us rto=2000us" (turnaround allowance) | " QUARANTINED 42s, probe in 8s"
+static inline String healthStatus(uint8_t id) {
+  if (!healthTracked(id)) return "";
+  const SlaveHealth &h = g_health[id];
+  if (h.quarantined) {
+    const int32_t due = (int32_t)(h.nextProbeMs - millis());
+    return " QUARANTINED " + String((millis() - h.sinceMs) / 1000) + "s, probe in " +
+           String(due > 0 ? due / 1000 : 0) + "s";
+  }
+  if (h.samples < MB_RTO_SAMPLES) return "";
+  return " srtt=" + String(h.srttUs) + "us rto=" + String(healthTurnaroundUs(id, 0xFFFFFFFFUL)) + "us";
+}
+
+#endif // SLAVE_HEALTH_H
@@ -0,0 +1,118 @@
+#ifndef TAGS_H
+#define TAGS_H
+
+#include <Arduino.h>
+#include <ctype.h>
+#include "config.h"
+#include "output.h"
+#include "runtime_state.h"
+
+/* ── Tagged commands ("#<tag> <command>") ────────────────────────────
+   Any command may carry a client-chosen tag (letters, digits, '-' and
+   '_', up to TAG_LEN chars). While a tagged command runs, every reply
+   it prints through printLineBoth() (output.h) is prefixed with "#<tag> ", and it
+   then ends with exactly one status line:
+
+     #<tag> rejected                the command printed an error
+     #<tag> done                    accepted, no motion involved
+     #<tag> accepted m1 m4          motion started on these axes ...
+     #<tag> done                    ... sent later, once all of them stopped
+                                    ("aborted" / "timeout" instead if any
+                                    axis was stopped or never reported)
+
+   Completion is motion done (the move-completion poll saw the axes
+   stop), not frames sent, so a client can keep many tagged moves in
+   flight and match the completions as they arrive, in any order. Up to
+   TAG_PENDING_MAX motion commands can be outstanding; beyond that a
+   tagged command is refused with "#<tag> rejected, err=TagsFull"
+   before it runs.
+*/
+static_assert(MAX_AXES < 64, "tag axis masks are 64 bits");
+
+struct TagPending {
+  char     tag[TAG_LEN + 1];    // "" = free slot
+  uint64_t axes;                // bit id: still moving
+  uint8_t  how;                 // worst AxisStop of the axes stopped so far
+};
+
+static TagPending g_tagPending[TAG_PENDING_MAX];
+static uint64_t   g_tagStarted = 0;             // axes started by the current command (g_tagCur)
+
+// Called wherever an axis is triggered
+static inline void tagNoteStart(uint8_t id) {
+  if (g_tagCur[0]) g_tagStarted |= (uint64_t)1 << id;
+}
+
+static inline int8_t tagFreeSlot() {
+  for (uint8_t i = 0; i < TAG_PENDING_MAX; ++i) {
+    if (!g_tagPending[i].tag[0]) return (int8_t)i;
+  }
+  return -1;
+}
+
+/* Strip a leading "#<tag>" off cmd and make it current.
+   Returns false if the command must not run (bad tag, no free slot). */
+static inline bool tagBegin(char *&cmd) {
+  g_tagCur[0]   = '\0';
+  g_tagStarted  = 0;
+  g_tagRejected = false;
+  if (cmd[0] != '#') return true;
+
+  uint8_t n = 0;
+  bool bad = false;
+  char *p = cmd + 1;
+  for (; *p && *p != ' ' && *p != '\t'; ++p) {
+    if (!isalnum((unsigned char)*p) && *p != '-' && *p != '_') bad = true;
+    else if (n < TAG_LEN) g_tagCur[n++] = *p;
+  }
+  g_tagCur[n] = '\0';
+  while (*p == ' ' || *p == '\t') ++p;
+  cmd = p;
+
+  if (!n || bad) { g_tagCur[0] = '\0'; printLineRaw("#, err=BadTag"); return false; }
+  if (tagFreeSlot() < 0) {
+    printLineRaw(tagPrefix() + "rejected, err=TagsFull");
+    g_tagCur[0] = '\0';
+    return false;
+  }
+  return true;
+}
+
+// After the command ran: status line, and a pending entry if it started motion
+static inline void tagEnd() {
+  if (!g_tagCur[0]) return;
+  if (g_tagRejected && !g_tagStarted) {
+    printLineRaw(tagPrefix() + "rejected");
+  } else if (!g_tagStarted) {
+    printLineRaw(tagPrefix() + "done");
+  } else {
+    String s = tagPrefix() + "accepted";
+    for (uint8_t id = 1; id <= MAX_AXES; ++id) {
+      if (g_tagStarted & ((uint64_t)1 << id)) s += " m" + String(id);
+    }
+    printLineRaw(s);
+    TagPending &t = g_tagPending[tagFreeSlot()];    // checked free in tagBegin
+    strcpy(t.tag, g_tagCur);
+    t.axes = g_tagStarted;
+    t.how  = STOP_DONE;
+  }
+  g_tagCur[0]  = '\0';
+  g_tagStarted = 0;
+}
+
+// Called when the move-completion poll sees an axis stop
+static inline void tagNoteStop(uint8_t id, AxisStop how) {
+  static const char *const kEnd[] = { "done", "timeout", "aborted" };   // by AxisStop
+  const uint64_t bit = (uint64_t)1 << id;
+  for (uint8_t i = 0; i < TAG_PENDING_MAX; ++i) {
+    TagPending &t = g_tagPending[i];
+    if (!t.tag[0] || !(t.axes & bit)) continue;
+    t.axes &= ~bit;
+    if (how > t.how) t.how = how;
+    if (t.axes) continue;
+    printLineRaw("#" + String(t.tag) + " " + kEnd[t.how]);
+    t.tag[0] = '\0';
+  }
+}
+
+#endif // TAGS_H
@@ -0,0 +1,92 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "config.h"
+#include "axis_table.h"
+#include "runtime_state.h"
+
+extern EthernetClient client;
+
+/* ── Periodic telemetry (TCP client only) ────────────────────────────
+   "telemetry 100" pushes the controller's view of every axis in the
+   table every 100 ms instead of the client polling "m<id>, read":
+
+     TK <seq> <id>:<pos>:<flags>[:<alarm>] ...     keyframe, all axes
+     TD <seq> <id>:<pos>:<flags>[:<alarm>] ...     delta, changed axes only
+
+   flags (hex): 1 enabled, 2 blockNeg, 4 blockPos, 8 moving, 10 alarm.
+   alarm (hex) is only present when non-zero. A delta with no axes
+   ("TD 57") still goes out as a heartbeat. Every TELEMETRY_KEY_EVERY-th
+   frame is a keyframe so a client that missed lines resynchronises.
+   Nothing touches the RS-485 bus; the stream is not echoed to Serial.
+   A new TCP connection ends the subscription.
+*/
+static const uint8_t TLM_ENABLED  = 0x01;
+static const uint8_t TLM_BLOCKNEG = 0x02;
+static const uint8_t TLM_BLOCKPOS = 0x04;
+static const uint8_t TLM_MOVING   = 0x08;
+static const uint8_t TLM_ALARM    = 0x10;
+
+struct TelemetrySnap {
+  int32_t  pos;
+  uint16_t alarm;
+  uint8_t  flags;
+};
+
+static uint32_t      g_tlmPeriodMs = 0;      // 0 = off
+static uint32_t      g_tlmLastMs   = 0;
+static uint32_t      g_tlmSeq      = 0;
+static uint8_t       g_tlmSinceKey = 0;
+static TelemetrySnap g_tlmSent[MAX_AXES + 1];
+
+static inline uint8_t telemetryFlags(const MotorState &m) {
+  return (uint8_t)((m.enabled  ? TLM_ENABLED  : 0) |
+                   (m.blockNeg ? TLM_BLOCKNEG : 0) |
+                   (m.blockPos ? TLM_BLOCKPOS : 0) |
+                   (m.moving   ? TLM_MOVING   : 0) |
+                   (m.alarm    ? TLM_ALARM    : 0));
+}
+
+static inline void telemetryStart(uint32_t periodMs) {
+  g_tlmPeriodMs = periodMs < TELEMETRY_MIN_MS ? TELEMETRY_MIN_MS : periodMs;
+  g_tlmLastMs   = millis() - g_tlmPeriodMs;   // first frame on the next loop
+  g_tlmSinceKey = 0;                          // ... and it is a keyframe
+}
+
+static inline void telemetryStop() {
+  g_tlmPeriodMs = 0;
+}
+
+static inline void serviceTelemetry() {
+  if (!g_tlmPeriodMs) return;
+  if (!(client && client.connected())) { telemetryStop(); return; }
+  const uint32_t now = millis();
+  if (now - g_tlmLastMs < g_tlmPeriodMs) return;
+  g_tlmLastMs = now;
+
+  const bool key = (g_tlmSinceKey == 0);
+  g_tlmSinceKey = (uint8_t)((g_tlmSinceKey + 1) % TELEMETRY_KEY_EVERY);
+
+  // Worst case per axis: " 255:-2147483648:1f:ffff" = 24 chars
+  char line[16 + 24 * MAX_AXES];
+  int  n = snprintf(line, sizeof(line), "%s %lu", key ? "TK" : "TD", (unsigned long)g_tlmSeq++);
+
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const uint8_t id = g_axes.ids[i];
+    const MotorState &m = mById(id);
+    TelemetrySnap cur = { m.position, m.alarm, telemetryFlags(m) };
+    TelemetrySnap &last = g_tlmSent[id];
+    if (!key && cur.pos == last.pos && cur.flags == last.flags && cur.alarm == last.alarm) continue;
+    last = cur;
+
+    n += cur.alarm
+       ? snprintf(line + n, sizeof(line) - n, " %u:%ld:%x:%x", id, (long)cur.pos, cur.flags, cur.alarm)
+       : snprintf(line + n, sizeof(line) - n, " %u:%ld:%x", id, (long)cur.pos, cur.flags);
+  }
+
+  client.println(line);
+}
+
+#endif // TELEMETRY_H
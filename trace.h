@@ -0,0 +1,113 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/* ── Flight recorder (in-RAM event ring) ─────────────────────────────
+   Fixed-size ring of 12-byte entries: commands parsed, frames sent,
+   replies received / timed out / rejected, limit-switch changes,
+   auto-disables, alarms and emergency stops. traceRecord() claims a slot with one atomic
+   fetch-add and fills it with plain stores — no lock, no allocation,
+   a few dozen cycles — so it is safe to call from any layer. The oldest
+   entries are overwritten.
+
+   "trace dump" streams the ring oldest-first. With "trace freeze on",
+   the first alarm freezes the ring so the events leading up to the
+   fault survive until "trace resume".
+*/
+enum TraceType : uint8_t {
+  TR_CMD = 1,      // a = line length, b = first 4 chars
+  TR_TX,           // a = register, b = fc << 16 | value (FC 0x06) or quantity
+  TR_RX_OK,        // a = fc, b = first data word (reads)
+  TR_RX_TIMEOUT,   // a = fc
+  TR_RX_EXC,       // a = fc, b = exception code
+  TR_RX_BAD,       // a = fc (wrong slave, fc or CRC)
+  TR_LIMIT,        // a = bit0 blockNeg, bit1 blockPos
+  TR_DISABLE,      // a = 1 broadcast, 0 single axis
+  TR_ALARM,        // a = alarm code
+  TR_ESTOP,        // broadcast quick-stop sent
+  TR_LASER         // a = 1 rising edge (b = width us), 0 falling edge (b = micros)
+};
+
+struct TraceEntry {
+  uint32_t us;     // micros()
+  uint8_t  type;
+  uint8_t  id;
+  uint16_t a;
+  uint32_t b;
+};
+
+static_assert((TRACE_ENTRIES & (TRACE_ENTRIES - 1)) == 0, "TRACE_ENTRIES must be a power of two");
+
+static TraceEntry        g_trace[TRACE_ENTRIES];
+static volatile uint32_t g_traceHead   = 0;      // total entries ever claimed
+static volatile bool     g_traceFrozen = false;
+static bool              g_traceFreezeOnAlarm = false;
+
+static inline void traceRecord(uint8_t type, uint8_t id, uint16_t a = 0, uint32_t b = 0) {
+  if (g_traceFrozen) return;
+  const uint32_t i = __atomic_fetch_add(&g_traceHead, 1u, __ATOMIC_RELAXED) & (TRACE_ENTRIES - 1);
+  TraceEntry &e = g_trace[i];
+  e.us   = micros();
+  e.type = type;
+  e.id   = id;
+  e.a    = a;
+  e.b    = b;
+}
+
+// Request frame going out (FC 0x03 / 0x06 / 0x10 share the same header layout)
+static inline void traceTx(const uint8_t *f) {
+  traceRecord(TR_TX, f[0], (uint16_t)((f[2] << 8) | f[3]),
+              ((uint32_t)f[1] << 16) | (uint32_t)((f[4] << 8) | f[5]));
+}
+
+static inline void traceAlarm(uint8_t id, uint16_t code) {
+  traceRecord(TR_ALARM, id, code);
+  if (g_traceFreezeOnAlarm && code != 0) g_traceFrozen = true;
+}
+
+static inline const char *traceTypeName(uint8_t t) {
+  switch (t) {
+    case TR_CMD:        return "cmd";
+    case TR_TX:         return "tx";
+    case TR_RX_OK:      return "rx";
+    case TR_RX_TIMEOUT: return "timeout";
+    case TR_RX_EXC:     return "exc";
+    case TR_RX_BAD:     return "bad";
+    case TR_LIMIT:      return "limit";
+    case TR_DISABLE:    return "disable";
+    case TR_ALARM:      return "alarm";
+    case TR_ESTOP:      return "estop";
+    case TR_LASER:      return "laser";
+    default:            return "?";
+  }
+}
+
+// Print the ring oldest-first, one line per event (printLineBoth from the parser)
+static inline void traceDump(void (*out)(const String &)) {
+  const bool wasFrozen = g_traceFrozen;
+  g_traceFrozen = true;                       // hold still while dumping
+
+  const uint32_t head = g_traceHead;
+  const uint32_t n = head < TRACE_ENTRIES ? head : TRACE_ENTRIES;
+  out("trace: " + String(n) + " of " + String(head) + (wasFrozen ? " events (frozen)" : " events"));
+
+  char line[64];
+  for (uint32_t k = head - n; k != head; ++k) {
+    const TraceEntry &e = g_trace[k & (TRACE_ENTRIES - 1)];
+    if (e.type == TR_CMD) {
+      char txt[5] = { (char)(e.b >> 24), (char)(e.b >> 16), (char)(e.b >> 8), (char)e.b, 0 };
+      snprintf(line, sizeof(line), "%lu cmd len=%u \"%s\"", (unsigned long)e.us, e.a, txt);
+    } else {
+      snprintf(line, sizeof(line), "%lu %s m%u %04x %lx", (unsigned long)e.us,
+               traceTypeName(e.type), e.id, e.a, (unsigned long)e.b);
+    }
+    out(String(line));
+  }
+  out("trace end");
+
+  g_traceFrozen = wasFrozen;
+}
+
+#endif // TRACE_H
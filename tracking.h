@@ -0,0 +1,167 @@
+#ifndef TRACKING_H
+#define TRACKING_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "output.h"
+#include "driver_io.h"
+#include "nv_store.h"
+#include "runtime_state.h"
+
+/* ── Constant-velocity tracking (PR0 velocity mode) ──────────────────
+   "m1, track <rpm>" starts continuous motion; further "track <rpm>"
+   commands while running rewrite only REG_PR0_VELOCITY (one frame, no
+   re-trigger), so fringe-tracking updates do not stutter. The
+   controller integrates the commanded velocity into MotorState::position
+   (exact integer arithmetic, ramps ignored) and, unless admin mode is on,
+   predicts when the axis would reach its soft limit — including the
+   stopping distance at the current decel — and stops it in time.
+   Limit switches in the direction of travel also stop it. A velocity
+   update the driver does not acknowledge stops the track. While a track
+   runs, the move-completion poll leaves the axis alone (a track at
+   0 RPM reads back as stopped); trackStop() hands it back.
+*/
+struct TrackState {
+  bool     active;
+  int16_t  rpm;
+  uint32_t lastMs;       // last integration time
+  int64_t  rem;          // integration remainder (step * 60000 units)
+  bool     hasDeadline;
+  uint32_t limitAtMs;    // predicted time to start stopping for the soft limit
+};
+
+static TrackState g_track[MAX_AXES + 1];
+static uint8_t    g_trackCount = 0;
+
+static inline bool trackActive(uint8_t id) {
+  return axisValidId(id) && g_track[id].active;
+}
+
+// Advance the controller position by rpm * microstep * dt / 60000 steps
+static inline void trackIntegrate(uint8_t id, uint32_t now) {
+  TrackState &t = g_track[id];
+  MotorState &m = mById(id);
+  int64_t num = (int64_t)t.rpm * (int64_t)m.microstep * (int64_t)(now - t.lastMs) + t.rem;
+  int64_t steps = num / 60000;
+  t.rem = num - steps * 60000;
+  t.lastMs = now;
+  m.position += (int32_t)steps;
+}
+
+// Distance covered while decelerating from |rpm| to 0 at the axis decel (ms per 1000 RPM)
+static inline int32_t trackStopDistance(uint8_t id, int16_t rpm) {
+  const MotorState &m = mById(id);
+  int64_t r = rpm < 0 ? -rpm : rpm;
+  return (int32_t)(r * r * (int64_t)m.microstep * (int64_t)m.decel / (60000LL * 2000LL));
+}
+
+// Predict when the axis must start stopping to stay inside its soft limit
+static inline void trackPlanLimit(uint8_t id) {
+  TrackState &t = g_track[id];
+  const MotorState &m = mById(id);
+  t.hasDeadline = false;
+  if (g_adminMode || t.rpm == 0) return;
+
+  int64_t room;
+  if (t.rpm > 0 && m.hasUpper)      room = (int64_t)m.upper - m.position;
+  else if (t.rpm < 0 && m.hasLower) room = (int64_t)m.position - m.lower;
+  else return;
+
+  room -= trackStopDistance(id, t.rpm);
+  const int64_t r = t.rpm < 0 ? -t.rpm : t.rpm;
+  const int64_t ms = room <= 0 ? 0 : room * 60000LL / (r * (int64_t)m.microstep);
+  t.hasDeadline = true;
+  t.limitAtMs = t.lastMs + (uint32_t)min(ms, (int64_t)0x7FFFFFFF);
+}
+
+// sendStop = false when the stop already went out (estop broadcast)
+static inline void trackStop(uint8_t id, const char *why, bool sendStop = true) {
+  if (!trackActive(id)) return;
+  TrackState &t = g_track[id];
+  MotorState &m = mById(id);
+
+  trackIntegrate(id, millis());
+  if (sendStop) stopMotor(id);
+  m.position += (t.rpm < 0 ? -1 : 1) * trackStopDistance(id, t.rpm);
+
+  t.active = false;
+  --g_trackCount;
+  m.lastMoveMs = millis();      // the move-completion poll arms auto-disable once stopped
+  nvSavePosition(id, m.position);
+  printLineBoth("m" + String(id) + ", track stopped (" + why + "), pos=" + String(m.position));
+}
+
+// Start tracking, or change the velocity of a running track
+static inline const char *trackSet(uint8_t id, int16_t rpm) {
+  MotorState &m = mById(id);
+  TrackState &t = g_track[id];
+  const uint32_t now = millis();
+
+  if (!g_adminMode) {
+    if (rpm > 0 && m.blockPos) return "Blocked";
+    if (rpm < 0 && m.blockNeg) return "Blocked";
+  }
+
+  if (t.active) {
+    trackIntegrate(id, now);
+    writeRegShadowed(id, REG_PR0_VELOCITY, (uint16_t)rpm);
+    if (!shadowMatches(id, REG_PR0_VELOCITY, (uint16_t)rpm)) {
+      // the driver may still run at the old speed: stop rather than guess
+      trackStop(id, "velocity write failed");
+      return "NoAck";
+    }
+  } else {
+    if (!ensureMotorEnabled(id)) return "NoAck";
+    writeRegShadowed(id, REG_PR0_MODE, PR0_MODE_VELOCITY);
+    writeRegShadowed(id, REG_PR0_VELOCITY, (uint16_t)rpm);
+    if (!shadowMatches(id, REG_PR0_MODE, PR0_MODE_VELOCITY) ||
+        !shadowMatches(id, REG_PR0_VELOCITY, (uint16_t)rpm)) return "NoAck";
+    uint8_t f[8]; buildTriggerFrame(id, f);
+    if (!tx(f)) return "NoAck";
+
+    t.active = true;
+    t.rem = 0;
+    t.lastMs = now;
+    ++g_trackCount;
+    historyMoveBegin(id);
+    tagNoteStart(id);
+    m.lastMoveMs = now;
+    m.moving = true;
+    m.settleMs = 0;
+    m.stopSent = false;
+    disableTimerCancel(id);
+  }
+
+  t.rpm = rpm;
+  m.lastDir = (rpm > 0) ? 1 : ((rpm < 0) ? -1 : m.lastDir);
+  trackPlanLimit(id);
+  if (t.hasDeadline && (int32_t)(now - t.limitAtMs) >= 0) {
+    trackStop(id, "soft limit");
+    return "AtLimit";
+  }
+  return nullptr;
+}
+
+static inline void serviceTracking() {
+  if (!g_trackCount) return;
+  const uint32_t now = millis();
+
+  for (uint8_t i = 0; i < g_axes.count; ++i) {
+    const uint8_t id = g_axes.ids[i];
+    TrackState &t = g_track[id];
+    if (!t.active) continue;
+    MotorState &m = mById(id);
+
+    if (!g_adminMode && ((t.rpm > 0 && m.blockPos) || (t.rpm < 0 && m.blockNeg))) {
+      trackStop(id, "limit switch");
+      continue;
+    }
+    if (t.hasDeadline && (int32_t)(now - t.limitAtMs) >= 0) {
+      trackStop(id, "soft limit");
+      continue;
+    }
+    if (now - t.lastMs >= TRACK_INTEGRATE_MS) trackIntegrate(id, now);
+  }
+}
+
+#endif // TRACKING_H